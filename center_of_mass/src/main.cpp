@@ -0,0 +1,482 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <fileioc.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "listview.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define ROWS 10
+
+#define R_AX 0
+#define R_AY 1
+#define R_D 2
+#define R_N 3
+#define R_M 4
+#define R_XCM 5
+#define R_YCM 6
+#define R_ICM 7
+#define R_I 8
+#define R_K 9
+
+#define EDIT_ROWS (BIT(R_AX) | BIT(R_AY) | BIT(R_D) | BIT(R_I))
+
+#define SHAPE_POINT 0
+#define SHAPE_DISK 1
+#define SHAPE_RING 2
+#define SHAPE_SPHERE 3
+#define SHAPE_SHELL 4
+#define SHAPE_ROD 5
+#define SHAPE_COUNT 6
+
+#define PLOT_LEFT 10
+#define PLOT_TOP 18
+#define PLOT_W 300
+#define PLOT_H 196
+
+// I about the shape's own center, as a multiple of m*size^2, for an axis
+// perpendicular to the plane. size is the radius, or the length for a rod.
+const float shapeFactor[SHAPE_COUNT] = {0, 0.5f, 1, 0.4f, 2 / 3.0f, 1 / 12.0f};
+
+// L1 = m, L2 = x, L3 = y, and optionally L4 = shape code with L5 = size.
+struct MassLists {
+    ListView m, x, y, shape, size;
+    bool hasShape;
+};
+
+// Running totals over the lists. The center of mass and the spread about it
+// are updated per entry (weighted Welford), so there is no large sum of m*r^2
+// to cancel against M*rcm^2 when the body sits far from the origin.
+struct MassSums {
+    int n;
+    float m, xcm, ycm;
+    float spread;
+    float shapeI;
+    float maxM;
+    float minX, maxX, minY, maxY;
+};
+
+struct ComState {
+    float vals[ROWS];
+    uint16_t known, userSet;
+};
+
+ComState cs;
+MassSums sums;
+const char* listErr = NULL;
+
+int curRow = 0;
+
+const char* rowLabels[ROWS] = {"ax", "ay", "d", "N", "M", "xcm", "ycm", "Icm", "I", "k"};
+const char* rowUnits[ROWS] = {"m", "m", "m", "", "kg", "m", "m", "kg*m^2", "kg*m^2", "m"};
+
+char eqUsed[64] = "";
+
+void closeMassLists(MassLists* l) {
+    closeList(&l->m);
+    closeList(&l->x);
+    closeList(&l->y);
+    closeList(&l->shape);
+    closeList(&l->size);
+}
+
+// Leaves the lists open for reading only when it succeeds.
+bool openMassLists(MassLists* l, const char** err) {
+    memset(l, 0, sizeof(*l));
+    const char* e = NULL;
+    if (!openList(ti_L1, &l->m) || !openList(ti_L2, &l->x) || !openList(ti_L3, &l->y)) {
+        e = "Need m, x, y in L1-L3";
+    } else if (l->x.count != l->m.count || l->y.count != l->m.count) {
+        e = "L1-L3 differ in length";
+    } else if (l->m.count == 0) {
+        e = "L1 is empty";
+    } else {
+        int n = l->m.count;
+        l->hasShape = openList(ti_L4, &l->shape) && l->shape.count == n;
+        if (l->hasShape && !(openList(ti_L5, &l->size) && l->size.count == n)) {
+            e = "Shapes in L4 need L5 size";
+        }
+    }
+    if (!e) return true;
+    closeMassLists(l);
+    *err = e;
+    return false;
+}
+
+int shapeAt(const MassLists* l, int i) {
+    return l->hasShape ? (int)listAt(&l->shape, i) : SHAPE_POINT;
+}
+
+// One pass over the lists, reading each element where the OS keeps it.
+// Adding a mass m at distance u from the running center moves the center by
+// u*m/M and adds m*u*(u - shift) to the spread: the parallel-axis theorem,
+// applied one entry at a time.
+bool addMasses(MassSums* s, const MassLists* l, const char** err) {
+    memset(s, 0, sizeof(*s));
+    for (int i = 0; i < l->m.count; i++) {
+        float m = listAt(&l->m, i);
+        float x = listAt(&l->x, i);
+        float y = listAt(&l->y, i);
+        int shape = shapeAt(l, i);
+        if (m < 0) {
+            *err = "Negative mass in L1";
+            return false;
+        }
+        if (shape < 0 || shape >= SHAPE_COUNT) {
+            *err = "Shape code must be 0-5";
+            return false;
+        }
+        if (shape != SHAPE_POINT) {
+            float size = listAt(&l->size, i);
+            s->shapeI += shapeFactor[shape] * m * size * size;
+        }
+        if (i == 0 || x < s->minX) s->minX = x;
+        if (i == 0 || x > s->maxX) s->maxX = x;
+        if (i == 0 || y < s->minY) s->minY = y;
+        if (i == 0 || y > s->maxY) s->maxY = y;
+        if (m > s->maxM) s->maxM = m;
+
+        s->m += m;
+        if (s->m == 0) continue;
+        float ux = x - s->xcm, uy = y - s->ycm;
+        float w = m / s->m;
+        s->xcm += ux * w;
+        s->ycm += uy * w;
+        s->spread += m * (ux * (x - s->xcm) + uy * (y - s->ycm));
+    }
+    s->n = l->m.count;
+    if (s->m <= 0) {
+        *err = "Total mass is zero";
+        return false;
+    }
+    return true;
+}
+
+bool sumLists(MassSums* s, const char** err) {
+    MassLists l;
+    if (!openMassLists(&l, err)) return false;
+    bool ok = addMasses(s, &l, err);
+    closeMassLists(&l);
+    return ok;
+}
+
+void initData() {
+    memset(&cs, 0, sizeof(cs));
+    cs.known = cs.userSet = BIT(R_AX) | BIT(R_AY);
+    listErr = NULL;
+    if (!sumLists(&sums, &listErr)) sums.n = 0;
+}
+
+bool isKnown(int i) {
+    return cs.known & BIT(i);
+}
+
+void derive(int i, float val, const char* eq) {
+    cs.vals[i] = val;
+    cs.known |= BIT(i);
+    addEq(eqUsed, eq);
+}
+
+// The sums fix everything about the center; the axis enters only through d,
+// so moving it costs nothing and needs no second pass over the lists.
+void autoSolve() {
+    float* v = cs.vals;
+    eqUsed[0] = '\0';
+    cs.known &= cs.userSet;
+    if (sums.n == 0) return;
+
+    v[R_N] = (float)sums.n;
+    cs.known |= BIT(R_N);
+    derive(R_M, sums.m, "M = sum(m)");
+    derive(R_XCM, sums.xcm, "rcm = sum(m*r)/M");
+    derive(R_YCM, sums.ycm, "rcm = sum(m*r)/M");
+    derive(R_ICM, sums.shapeI + sums.spread, "Icm = sum(Ishape + m*r'^2)");
+    float m = v[R_M];
+
+    if (!isKnown(R_D) && isKnown(R_AX) && isKnown(R_AY)) {
+        float dx = v[R_AX] - v[R_XCM], dy = v[R_AY] - v[R_YCM];
+        derive(R_D, sqrtf(dx * dx + dy * dy), "d = |axis - rcm|");
+    }
+    if (!isKnown(R_D) && isKnown(R_I) && v[R_I] >= v[R_ICM]) {
+        derive(R_D, sqrtf((v[R_I] - v[R_ICM]) / m), "I = Icm + M*d^2");
+    }
+    if (!isKnown(R_I) && isKnown(R_D)) derive(R_I, v[R_ICM] + m * v[R_D] * v[R_D], "I = Icm + M*d^2");
+    if (isKnown(R_I) && v[R_I] >= 0) derive(R_K, sqrtf(v[R_I] / m), "k = sqrt(I/M)");
+}
+
+void setCell(int row, bool set, float val) {
+    cs.vals[row] = set ? val : 0;
+    if (set) {
+        cs.known |= BIT(row);
+        cs.userSet |= BIT(row);
+    } else {
+        cs.known &= ~BIT(row);
+        cs.userSet &= ~BIT(row);
+    }
+}
+
+struct PlotMap {
+    float x0, y0, scale;
+};
+
+int mapX(const PlotMap* p, float x) {
+    return PLOT_LEFT + (int)((x - p->x0) * p->scale);
+}
+
+int mapY(const PlotMap* p, float y) {
+    return PLOT_TOP + PLOT_H - (int)((y - p->y0) * p->scale);
+}
+
+// Equal scales on both axes, framing the masses, the center and the axis.
+void fitPlot(PlotMap* p, float ax, float ay, bool hasAxis) {
+    float minX = sums.minX, maxX = sums.maxX, minY = sums.minY, maxY = sums.maxY;
+    if (hasAxis) {
+        if (ax < minX) minX = ax;
+        if (ax > maxX) maxX = ax;
+        if (ay < minY) minY = ay;
+        if (ay > maxY) maxY = ay;
+    }
+    float w = maxX - minX, h = maxY - minY;
+    float span = (w * PLOT_H > h * PLOT_W) ? w / PLOT_W : h / PLOT_H;
+    if (span <= 0) span = 1.0f / PLOT_H;
+    p->scale = 0.9f / span;
+    p->x0 = 0.5f * (minX + maxX) - 0.5f * PLOT_W / p->scale;
+    p->y0 = 0.5f * (minY + maxY) - 0.5f * PLOT_H / p->scale;
+}
+
+// A second streaming pass that draws each entry straight from the lists.
+// Dot area follows mass; sized shapes also get their outline to scale.
+void runPlot() {
+    MassLists l;
+    const char* err = listErr;
+    if (sums.n == 0 || !openMassLists(&l, &err)) {
+        drawMessage(err ? err : "No lists read");
+        return;
+    }
+    const float* v = cs.vals;
+    bool hasAxis = isKnown(R_AX) && isKnown(R_AY);
+    PlotMap map;
+    fitPlot(&map, v[R_AX], v[R_AY], hasAxis);
+
+    gfx_FillScreen(255);
+    gfx_SetColor(200);
+    gfx_Rectangle(PLOT_LEFT, PLOT_TOP, PLOT_W + 1, PLOT_H + 1);
+    for (int i = 0; i < l.m.count; i++) {
+        int px = mapX(&map, listAt(&l.x, i));
+        int py = mapY(&map, listAt(&l.y, i));
+        int shape = shapeAt(&l, i);
+        if (shape != SHAPE_POINT) {
+            int r = (int)(listAt(&l.size, i) * map.scale);
+            gfx_SetColor(148);
+            if (shape == SHAPE_ROD) gfx_HorizLine(px - r / 2, py, r);
+            else if (r > 0) gfx_Circle(px, py, r);
+        }
+        int dot = 1 + (int)(4 * sqrtf(listAt(&l.m, i) / sums.maxM));
+        gfx_SetColor(24);
+        gfx_FillCircle(px, py, dot);
+    }
+    closeMassLists(&l);
+
+    int cx = mapX(&map, v[R_XCM]), cy = mapY(&map, v[R_YCM]);
+    gfx_SetColor(224);
+    gfx_Line(cx - 5, cy - 5, cx + 5, cy + 5);
+    gfx_Line(cx - 5, cy + 5, cx + 5, cy - 5);
+    if (hasAxis) {
+        int axX = mapX(&map, v[R_AX]), axY = mapY(&map, v[R_AY]);
+        gfx_SetColor(7);
+        gfx_Circle(axX, axY, 4);
+        gfx_FillCircle(axX, axY, 1);
+        gfx_Line(axX, axY, cx, cy);
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("x: center of mass  o: axis", 56, 4);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("Any key to return", 101, 228);
+    gfx_BlitBuffer();
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+void drawTable() {
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("MASS DISTRIBUTION - Evan Kolberg", 32, 3);
+
+    int startX = 5;
+    int startY = 16;
+    int rowH = 15;
+    int labelW = 40;
+    int boxW = 84;
+
+    for (int row = 0; row < ROWS; row++) {
+        int y = startY + row * rowH;
+        bool selected = (row == curRow && !inputMode);
+        bool editing = (row == curRow && inputMode);
+        int x = startX + labelW;
+
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(rowLabels[row], startX + 2, y + 3);
+
+        if (selected) {
+            gfx_SetColor(183);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        } else if (editing) {
+            gfx_SetColor(239);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        }
+        gfx_SetColor((EDIT_ROWS & BIT(row)) ? 0 : 181);
+        gfx_Rectangle(x, y, boxW, rowH - 2);
+
+        char buf[15];
+        if (editing) {
+            inputText(buf);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else if (isKnown(row)) {
+            floatToStr(cs.vals[row], buf);
+            gfx_SetTextFGColor((cs.userSet & BIT(row)) ? 0 : 24);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else {
+            gfx_PrintStringXY("?", x + boxW / 2 - 4, y + 3);
+        }
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(rowUnits[row], x + boxW + 4, y + 3);
+    }
+
+    int rightX = 190;
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("L1 m  L2 x  L3 y", rightX, startY + 3);
+    gfx_PrintStringXY("L4 shape L5 size", rightX, startY + rowH + 3);
+    if (listErr) {
+        gfx_SetTextFGColor(224);
+        gfx_PrintStringXY(listErr, 5, startY + ROWS * rowH + 4);
+        gfx_SetTextFGColor(24);
+    }
+    gfx_PrintStringXY("0 point 1 disk", rightX, startY + 2 * rowH + 3);
+    gfx_PrintStringXY("2 ring 3 sphere", rightX, startY + 3 * rowH + 3);
+    gfx_PrintStringXY("4 shell 5 rod", rightX, startY + 4 * rowH + 3);
+    gfx_PrintStringXY("graph: plot", rightX, startY + 6 * rowH);
+    gfx_PrintStringXY("window: reread", rightX, startY + 7 * rowH);
+    gfx_PrintStringXY("del: clear cell", rightX, startY + 8 * rowH);
+    gfx_PrintStringXY("mode: reset", rightX, startY + 9 * rowH);
+    gfx_PrintStringXY("clear: quit", rightX, startY + 10 * rowH);
+
+    int eqY = startY + ROWS * rowH + (listErr ? 14 : 4);
+    printEqList(eqUsed, eqY);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(curRow, true, parseInput());
+        // The axis, d and I each fix the other two, so entering one of them
+        // drops whichever of the others was set before.
+        bool axis = (curRow == R_AX || curRow == R_AY);
+        if (!axis) {
+            setCell(R_AX, false, 0);
+            setCell(R_AY, false, 0);
+        }
+        if (curRow != R_D) setCell(R_D, false, 0);
+        if (curRow != R_I) setCell(R_I, false, 0);
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, false, 0);
+    autoSolve();
+}
+
+// The table, the list sums and the equations. The sums come back as they
+// were read; window rereads the lists if they have changed.
+const ModChunk stateChunks[] = {
+    {&cs, sizeof(cs)},
+    {&sums, sizeof(sums)},
+    {eqUsed, sizeof(eqUsed)}
+};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(MASS_STATE_VAR);
+    if (!resume || !loadModState(MASS_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevEnter = false, prevClear = false, prevDel = false;
+    bool prevMode = false, prevGraph = false, prevWindow = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool window = kb_Data[1] & kb_Window;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+
+        bool editable = EDIT_ROWS & BIT(curRow);
+        if (!inputMode) {
+            if (enter && !prevEnter && editable) startInput();
+            if (del && !prevDel && editable) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (window && !prevWindow) {
+                listErr = NULL;
+                if (!sumLists(&sums, &listErr)) sums.n = 0;
+                autoSolve();
+            }
+            if (graph && !prevGraph) runPlot();
+            if (clear && !prevClear) running = false;
+
+            if (editable) startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        curRow = (curRow + move + ROWS) % ROWS;
+
+        prevUp = up; prevDown = down; prevEnter = enter; prevClear = clear; prevDel = del;
+        prevMode = mode; prevGraph = graph; prevWindow = window; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(MASS_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef COMMON_ARROW_H
+#define COMMON_ARROW_H
+
+#include <graphx.h>
+
+inline int isqrt(int n) {
+    int r = 0;
+    while ((r + 1) * (r + 1) <= n) r++;
+    return r;
+}
+
+// Arrowheads from the pixel direction alone: a head of 8 pixels at about 30
+// degrees either side, using cos 30 ~ 7/8 and sin 30 = 1/2.
+inline void drawArrow(int x0, int y0, int x1, int y1) {
+    gfx_Line(x0, y0, x1, y1);
+    int dx = x1 - x0, dy = y1 - y0;
+    int len = isqrt(dx * dx + dy * dy);
+    if (len < 4) return;
+    int hx = dx * 8 / len, hy = dy * 8 / len;
+    gfx_Line(x1, y1, x1 - (hx * 7 - hy * 4) / 8, y1 - (hy * 7 + hx * 4) / 8);
+    gfx_Line(x1, y1, x1 - (hx * 7 + hy * 4) / 8, y1 - (hy * 7 - hx * 4) / 8);
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef COMMON_DEGTRIG_H
+#define COMMON_DEGTRIG_H
+
+#include <math.h>
+
+// sin of 0..90 whole degrees, evaluated by the compiler from a Taylor series.
+constexpr double sinSeries(double x) {
+    double term = x, sum = x;
+    for (int n = 1; n < 10; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+struct DegTable {
+    float sinDeg[91];
+    constexpr DegTable() : sinDeg() {
+        for (int d = 0; d <= 90; d++) sinDeg[d] = (float)sinSeries(d * 3.14159265358979 / 180);
+    }
+};
+
+constexpr DegTable degTable;
+
+inline float sinDeg(int deg) {
+    deg %= 360;
+    if (deg < 0) deg += 360;
+    if (deg <= 90) return degTable.sinDeg[deg];
+    if (deg <= 180) return degTable.sinDeg[180 - deg];
+    if (deg <= 270) return -degTable.sinDeg[deg - 180];
+    return -degTable.sinDeg[360 - deg];
+}
+
+inline float cosDeg(int deg) {
+    return sinDeg(deg + 90);
+}
+
+// Any angle in degrees: the table gives the whole degree and the angle-sum
+// rule adds the fraction f (under 0.0175 rad), where sin f ~ f - f^3/6 and
+// cos f ~ 1 - f^2/2 are good to about 4e-9.
+inline void sinCosDeg(float deg, float* s, float* c) {
+    int d = (int)floorf(deg);
+    float f = (deg - d) * (3.14159265f / 180);
+    float sd = sinDeg(d), cd = cosDeg(d);
+    float sf = f * (1 - f * f / 6), cf = 1 - f * f / 2;
+    *s = sd * cf + cd * sf;
+    *c = cd * cf - sd * sf;
+}
+
+// Components of n vectors given as magnitude and heading in degrees.
+inline void polarToXY(const float* mag, const float* deg, float* x, float* y, int n) {
+    for (int i = 0; i < n; i++) {
+        float s, c;
+        sinCosDeg(deg[i], &s, &c);
+        x[i] = mag[i] * c;
+        y[i] = mag[i] * s;
+    }
+}
+
+// Magnitudes and headings in [0, 360) of n vectors given as components.
+inline void xyToPolar(const float* x, const float* y, float* mag, float* deg, int n) {
+    for (int i = 0; i < n; i++) {
+        mag[i] = sqrtf(x[i] * x[i] + y[i] * y[i]);
+        float a = atan2f(y[i], x[i]) * (180 / 3.14159265f);
+        deg[i] = (a < 0) ? a + 360 : a;
+    }
+}
+
+#endif
@@ -0,0 +1,368 @@
+#ifndef COMMON_KINEMATICS_H
+#define COMMON_KINEMATICS_H
+
+#include <math.h>
+#include <string.h>
+#include "numfmt.h"
+
+#define VAR_COUNT 7
+
+#define BIT(i) (1 << (i))
+
+// Row names for trySolve's seven variables. The rule text below is written with
+// the linear names; a module with its own names passes them as Names.
+struct LinearNames {
+    static constexpr const char* var[VAR_COUNT] = {"p0", "pf", "v0", "vf", "a", "d", "t"};
+};
+
+inline float sqrtT(float v) { return sqrtf(v); }
+inline float sinT(float v) { return sinf(v); }
+inline float cosT(float v) { return cosf(v); }
+inline float atan2T(float y, float x) { return atan2f(y, x); }
+
+#ifdef VERIFY64
+inline long double sqrtT(long double v) { return sqrtl(v); }
+inline long double sinT(long double v) { return sinl(v); }
+inline long double cosT(long double v) { return cosl(v); }
+inline long double atan2T(long double y, long double x) { return atan2l(y, x); }
+#endif
+
+template <typename Names = LinearNames>
+void addEq(char* eqUsed, const char* eq) {
+    if (eqUsed == NULL) return;
+    char text[40];
+    int len = 0;
+    while (*eq) {
+        if (*eq < 'a' || *eq > 'z') {
+            if (len < 36) text[len++] = *eq;
+            eq++;
+            continue;
+        }
+        const char* word = eq;
+        while ((*eq >= 'a' && *eq <= 'z') || (*eq >= '0' && *eq <= '9')) eq++;
+        int n = eq - word;
+        const char* name = NULL;
+        for (int i = 0; i < VAR_COUNT; i++) {
+            if ((int)strlen(LinearNames::var[i]) == n && !strncmp(LinearNames::var[i], word, n)) name = Names::var[i];
+        }
+        if (name) {
+            word = name;
+            n = strlen(name);
+        }
+        if (len + n < 36) {
+            memcpy(text + len, word, n);
+            len += n;
+        }
+    }
+    text[len] = '\0';
+
+    if (strstr(eqUsed, text) != NULL) return;
+    if (eqUsed[0] == '\0') {
+        strcpy(eqUsed, text);
+    } else if (strlen(eqUsed) + len + 2 < 60) {
+        strcat(eqUsed, "|");
+        strcat(eqUsed, text);
+    }
+}
+
+// Real roots of a*x^2 + b*x + c = 0 for a != 0. The larger-magnitude root comes
+// from q = -(b + sign(b)*sqrt(disc))/2 and the other from the root product c/a,
+// so neither subtracts two nearly equal terms. Returns false if there are none.
+template <typename T>
+bool solveQuadratic(T a, T b, T c, T* r1, T* r2) {
+    T disc = b * b - 4 * a * c;
+    if (disc < 0) return false;
+    T sq = sqrtT(disc);
+    T q = -0.5f * ((b < 0) ? b - sq : b + sq);
+    if (q == 0) {
+        *r1 = 0;
+        *r2 = 0;
+    } else {
+        *r1 = q / a;
+        *r2 = c / q;
+    }
+    return true;
+}
+
+template <typename T>
+bool pickTime(T t1, T t2, T* t) {
+    T tMax = (t1 > t2) ? t1 : t2;
+    T tMin = (t1 < t2) ? t1 : t2;
+    if (tMax > 0.001f) {
+        *t = tMax;
+        return true;
+    }
+    if (tMin >= 0) {
+        *t = tMin;
+        return true;
+    }
+    return false;
+}
+
+// trySolve for a row whose a is known to be exactly zero. Velocity is then
+// constant, so only the displacement rules and d = v*t are left: no
+// quadratics, no square roots, and t is the only divisor to guard.
+template <typename Names = LinearNames, typename T>
+uint8_t trySolveUniform(T* vals, uint8_t* sig, uint8_t known, uint8_t userSet, char* eqUsed) {
+    T p0 = vals[0], pf = vals[1], v0 = vals[2], vf = vals[3], d = vals[5], t = vals[6];
+    bool kp0 = known & BIT(0), kpf = known & BIT(1), kv0 = known & BIT(2), kvf = known & BIT(3);
+    bool kd = known & BIT(5), kt = known & BIT(6);
+    uint8_t sP0 = sig[0], sPf = sig[1], sV0 = sig[2], sVf = sig[3], sD = sig[5], sT = sig[6];
+
+    // Two passes cover every chain: a d found from v*t can still fix p0 or pf.
+    for (int iter = 0; iter < 2; iter++) {
+        if (!kvf && kv0) {
+            vf = v0;
+            sVf = sV0;
+            kvf = true;
+            addEq<Names>(eqUsed, "vf = v0 (a=0)");
+        }
+        if (!kv0 && kvf) {
+            v0 = vf;
+            sV0 = sVf;
+            kv0 = true;
+            addEq<Names>(eqUsed, "v0 = vf (a=0)");
+        }
+        if (!kd && kp0 && kpf) {
+            d = pf - p0;
+            sD = sigSum(d, pf, sPf, p0, sP0);
+            kd = true;
+            addEq<Names>(eqUsed, "d = pf - p0");
+        }
+        if (!kd && kv0 && kt) {
+            d = v0 * t;
+            sD = sigMin(sV0, sT);
+            kd = true;
+            addEq<Names>(eqUsed, "d = v0*t");
+        }
+        if (!kv0 && kd && kt && t != 0) {
+            v0 = vf = d / t;
+            sV0 = sVf = sigMin(sD, sT);
+            kv0 = kvf = true;
+            addEq<Names>(eqUsed, "v0 = d / t");
+        }
+        if (!kt && kd && kv0 && v0 != 0) {
+            t = d / v0;
+            sT = sigMin(sD, sV0);
+            if (t >= 0) { kt = true; addEq<Names>(eqUsed, "t = d / v0"); }
+        }
+        if (!kpf && kp0 && kd) {
+            pf = p0 + d;
+            sPf = sigSum(pf, p0, sP0, d, sD);
+            kpf = true;
+            addEq<Names>(eqUsed, "pf = p0 + d");
+        }
+        if (!kp0 && kpf && kd) {
+            p0 = pf - d;
+            sP0 = sigSum(p0, pf, sPf, d, sD);
+            kp0 = true;
+            addEq<Names>(eqUsed, "p0 = pf - d");
+        }
+    }
+
+    vals[0] = p0; vals[1] = pf; vals[2] = v0; vals[3] = vf; vals[5] = d; vals[6] = t;
+    sig[0] = sP0; sig[1] = sPf; sig[2] = sV0; sig[3] = sVf; sig[5] = sD; sig[6] = sT;
+
+    uint8_t solved = kp0 | kpf << 1 | kv0 << 2 | kvf << 3 | kd << 5 | kt << 6;
+    return known | (solved & ~userSet);
+}
+
+// ZeroAccel picks the a = 0 rule set at compile time. The caller must only
+// set it when row a is known and exactly zero.
+template <typename Names = LinearNames, bool ZeroAccel = false, typename T>
+uint8_t trySolve(T* vals, uint8_t* sig, uint8_t known, uint8_t userSet, char* eqUsed) {
+    if constexpr (ZeroAccel) return trySolveUniform<Names>(vals, sig, known, userSet, eqUsed);
+
+    T p0 = vals[0], pf = vals[1], v0 = vals[2], vf = vals[3], a = vals[4], d = vals[5], t = vals[6];
+    bool kp0 = known & BIT(0), kpf = known & BIT(1), kv0 = known & BIT(2), kvf = known & BIT(3);
+    bool ka = known & BIT(4), kd = known & BIT(5), kt = known & BIT(6);
+    uint8_t sP0 = sig[0], sPf = sig[1], sV0 = sig[2], sVf = sig[3], sA = sig[4], sD = sig[5], sT = sig[6];
+    
+    for (int iter = 0; iter < 20; iter++) {
+        if (!kd && kp0 && kpf) {
+            d = pf - p0;
+            sD = sigSum(d, pf, sPf, p0, sP0);
+            kd = true;
+            addEq<Names>(eqUsed, "d = pf - p0");
+        }
+        if (!kpf && kp0 && kd) {
+            pf = p0 + d;
+            sPf = sigSum(pf, p0, sP0, d, sD);
+            kpf = true;
+            addEq<Names>(eqUsed, "pf = p0 + d");
+        }
+        if (!kp0 && kpf && kd) {
+            p0 = pf - d;
+            sP0 = sigSum(p0, pf, sPf, d, sD);
+            kp0 = true;
+            addEq<Names>(eqUsed, "p0 = pf - d");
+        }
+        if (!kt && kv0 && kvf && ka && a != 0) {
+            t = (vf - v0) / a;
+            sT = sigMin(sigSum(vf - v0, vf, sVf, v0, sV0), sA);
+            if (t >= 0) { kt = true; addEq<Names>(eqUsed, "t = (vf - v0) / a"); }
+        }
+        if (!kvf && kv0 && ka && a == 0) {
+            vf = v0;
+            sVf = sV0;
+            kvf = true;
+            addEq<Names>(eqUsed, "vf = v0 (a=0)");
+        }
+        if (!kv0 && kvf && ka && a == 0) {
+            v0 = vf;
+            sV0 = sVf;
+            kv0 = true;
+            addEq<Names>(eqUsed, "v0 = vf (a=0)");
+        }
+        if (!kvf && kv0 && ka && kt) {
+            vf = v0 + a * t;
+            sVf = sigSum(vf, v0, sV0, a * t, sigMin(sA, sT));
+            kvf = true;
+            addEq<Names>(eqUsed, "vf = v0 + a*t");
+        }
+        if (!kv0 && kvf && ka && kt) {
+            v0 = vf - a * t;
+            sV0 = sigSum(v0, vf, sVf, a * t, sigMin(sA, sT));
+            kv0 = true;
+            addEq<Names>(eqUsed, "v0 = vf - a*t");
+        }
+        if (!ka && kv0 && kvf && kt && t != 0) {
+            a = (vf - v0) / t;
+            sA = sigMin(sigSum(vf - v0, vf, sVf, v0, sV0), sT);
+            ka = true;
+            addEq<Names>(eqUsed, "a = (vf - v0) / t");
+        }
+        if (!kd && kv0 && kt && ka) {
+            d = v0 * t + 0.5f * a * t * t;
+            sD = sigSum(d, v0 * t, sigMin(sV0, sT), 0.5f * a * t * t, sigMin(sA, sT));
+            kd = true;
+            addEq<Names>(eqUsed, "d = v0*t + .5*a*t^2");
+        }
+        if (!kv0 && kd && kt && ka && t != 0) {
+            v0 = (d - 0.5f * a * t * t) / t;
+            sV0 = sigMin(sigSum(v0 * t, d, sD, 0.5f * a * t * t, sigMin(sA, sT)), sT);
+            kv0 = true;
+            addEq<Names>(eqUsed, "v0 = (d - .5*a*t^2) / t");
+        }
+        if (!ka && kv0 && kd && kt && t != 0) {
+            a = 2 * (d - v0 * t) / (t * t);
+            sA = sigMin(sigSum(d - v0 * t, d, sD, v0 * t, sigMin(sV0, sT)), sT);
+            ka = true;
+            addEq<Names>(eqUsed, "a = 2(d - v0*t) / t^2");
+        }
+        if (!kd && kv0 && kvf && kt) {
+            d = (v0 + vf) * 0.5f * t;
+            sD = sigMin(sigSum(v0 + vf, v0, sV0, vf, sVf), sT);
+            kd = true;
+            addEq<Names>(eqUsed, "d = (v0 + vf) * t / 2");
+        }
+        if (!kt && kv0 && kvf && kd && (v0 + vf) != 0) {
+            t = 2 * d / (v0 + vf);
+            sT = sigMin(sD, sigSum(v0 + vf, v0, sV0, vf, sVf));
+            if (t >= 0) { kt = true; addEq<Names>(eqUsed, "t = 2*d / (v0 + vf)"); }
+        }
+        if (!kv0 && kvf && kd && kt && t != 0) {
+            v0 = 2 * d / t - vf;
+            sV0 = sigSum(v0, 2 * d / t, sigMin(sD, sT), vf, sVf);
+            kv0 = true;
+            addEq<Names>(eqUsed, "v0 = 2*d / t - vf");
+        }
+        if (!kvf && kv0 && kd && kt && t != 0) {
+            vf = 2 * d / t - v0;
+            sVf = sigSum(vf, 2 * d / t, sigMin(sD, sT), v0, sV0);
+            kvf = true;
+            addEq<Names>(eqUsed, "vf = 2*d / t - v0");
+        }
+
+        if (!kd && kvf && kt && ka) {
+            d = vf * t - 0.5f * a * t * t;
+            sD = sigSum(d, vf * t, sigMin(sVf, sT), 0.5f * a * t * t, sigMin(sA, sT));
+            kd = true;
+            addEq<Names>(eqUsed, "d = vf*t - .5*a*t^2");
+        }
+        if (!kvf && kd && kt && ka && t != 0) {
+            vf = (d + 0.5f * a * t * t) / t;
+            sVf = sigMin(sigSum(vf * t, d, sD, 0.5f * a * t * t, sigMin(sA, sT)), sT);
+            kvf = true;
+            addEq<Names>(eqUsed, "vf = (d + .5*a*t^2) / t");
+        }
+        if (!ka && kvf && kd && kt && t != 0) {
+            a = 2 * (vf * t - d) / (t * t);
+            sA = sigMin(sigSum(vf * t - d, vf * t, sigMin(sVf, sT), d, sD), sT);
+            ka = true;
+            addEq<Names>(eqUsed, "a = 2(vf*t - d) / t^2");
+        }
+        if (!kt && kvf && kd && ka) {
+            if (a != 0) {
+                T t1, t2;
+                if (solveQuadratic(0.5f * a, -vf, d, &t1, &t2) && pickTime(t1, t2, &t)) {
+                    sT = sigMin(sVf, sigMin(sD, sA));
+                    kt = true;
+                    addEq<Names>(eqUsed, "d = vf*t - .5*a*t^2");
+                }
+            } else if (vf != 0) {
+                t = d / vf;
+                sT = sigMin(sD, sVf);
+                if (t >= 0) { kt = true; addEq<Names>(eqUsed, "t = d / vf"); }
+            }
+        }
+        if (!kt && kv0 && kd && ka) {
+            if (a != 0) {
+                T t1, t2;
+                if (solveQuadratic(0.5f * a, v0, -d, &t1, &t2) && pickTime(t1, t2, &t)) {
+                    sT = sigMin(sV0, sigMin(sD, sA));
+                    kt = true;
+                    addEq<Names>(eqUsed, "d = v0*t + .5*a*t^2");
+                }
+            } else if (v0 != 0) {
+                t = d / v0;
+                sT = sigMin(sD, sV0);
+                if (t >= 0) { kt = true; addEq<Names>(eqUsed, "t = d / v0"); }
+            }
+        }
+        if (!kvf && kv0 && ka && kd) {
+            T disc = v0 * v0 + 2 * a * d;
+            if (disc >= 0) {
+                T vfMag = sqrtT(disc);
+                if (kt) vf = (v0 + a * t >= 0) ? vfMag : -vfMag;
+                else if (v0 != 0) vf = (v0 > 0) ? vfMag : -vfMag;
+                else vf = (a * d >= 0) ? vfMag : -vfMag;
+                sVf = sigMin(sV0, sigMin(sA, sD));
+                kvf = true;
+                addEq<Names>(eqUsed, "vf^2 = v0^2 + 2*a*d");
+            }
+        }
+        if (!kv0 && kvf && ka && kd) {
+            T disc = vf * vf - 2 * a * d;
+            if (disc >= 0) {
+                T v0Mag = sqrtT(disc);
+                if (kt) v0 = (vf - a * t >= 0) ? v0Mag : -v0Mag;
+                else if (vf != 0) v0 = (vf > 0) ? v0Mag : -v0Mag;
+                else v0 = (a * d <= 0) ? v0Mag : -v0Mag;
+                sV0 = sigMin(sVf, sigMin(sA, sD));
+                kv0 = true;
+                addEq<Names>(eqUsed, "v0^2 = vf^2 - 2*a*d");
+            }
+        }
+        if (!ka && kv0 && kvf && kd && d != 0) {
+            a = (vf * vf - v0 * v0) / (2 * d);
+            sA = sigMin(sigMin(sVf, sV0), sD);
+            ka = true;
+            addEq<Names>(eqUsed, "a = (vf^2 - v0^2) / 2*d");
+        }
+        if (!kd && kv0 && kvf && ka && a != 0) {
+            d = (vf * vf - v0 * v0) / (2 * a);
+            sD = sigMin(sigMin(sVf, sV0), sA);
+            kd = true;
+            addEq<Names>(eqUsed, "d = (vf^2 - v0^2) / 2*a");
+        }
+    }
+    
+    vals[0] = p0; vals[1] = pf; vals[2] = v0; vals[3] = vf; vals[4] = a; vals[5] = d; vals[6] = t;
+    sig[0] = sP0; sig[1] = sPf; sig[2] = sV0; sig[3] = sVf; sig[4] = sA; sig[5] = sD; sig[6] = sT;
+
+    uint8_t solved = kp0 | kpf << 1 | kv0 << 2 | kvf << 3 | ka << 4 | kd << 5 | kt << 6;
+    return known | (solved & ~userSet);
+}
+
+#endif
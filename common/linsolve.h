@@ -0,0 +1,37 @@
+#ifndef COMMON_LINSOLVE_H
+#define COMMON_LINSOLVE_H
+
+#include <math.h>
+
+// Solves the N x N system held in the augmented matrix m in place, with
+// partial pivoting. N is a template argument so the loops have fixed bounds
+// and the matrix lives on the caller's stack. Returns false if singular.
+template <int N>
+bool gaussSolve(float m[N][N + 1], float x[N]) {
+    for (int k = 0; k < N; k++) {
+        int piv = k;
+        for (int i = k + 1; i < N; i++) {
+            if (fabsf(m[i][k]) > fabsf(m[piv][k])) piv = i;
+        }
+        if (fabsf(m[piv][k]) < 1e-20f) return false;
+        if (piv != k) {
+            for (int j = k; j <= N; j++) {
+                float tmp = m[k][j];
+                m[k][j] = m[piv][j];
+                m[piv][j] = tmp;
+            }
+        }
+        for (int i = k + 1; i < N; i++) {
+            float f = m[i][k] / m[k][k];
+            for (int j = k; j <= N; j++) m[i][j] -= f * m[k][j];
+        }
+    }
+    for (int k = N - 1; k >= 0; k--) {
+        float sum = m[k][N];
+        for (int j = k + 1; j < N; j++) sum -= m[k][j] * x[j];
+        x[k] = sum / m[k][k];
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef COMMON_LISTVIEW_H
+#define COMMON_LISTVIEW_H
+
+#include <tice.h>
+#include <fileioc.h>
+#include <ti/real.h>
+
+// A TI list read in place; elements stay in the OS's real_t format, so even
+// a list of hundreds of entries costs no program RAM.
+// elems points into the variable itself, so it is only good from openList to
+// the matching closeList, and only while nothing creates, resizes, deletes or
+// archives a variable: any of those can move the list in RAM.
+struct ListView {
+    const real_t* elems;
+    int count;
+    uint8_t handle;
+};
+
+// Always pair with closeList, even when this fails; a ListView that was
+// zeroed and never opened may be closed too.
+inline bool openList(const char* name, ListView* l) {
+    l->handle = ti_OpenVar(name, "r", OS_TYPE_REAL_LIST);
+    if (!l->handle) return false;
+    const uint8_t* data = (const uint8_t*)ti_GetDataPtr(l->handle);
+    l->count = data[0] | (data[1] << 8);
+    l->elems = (const real_t*)(data + 2);
+    return true;
+}
+
+inline void closeList(ListView* l) {
+    if (l->handle) ti_Close(l->handle);
+    l->handle = 0;
+}
+
+inline float listAt(const ListView* l, int i) {
+    return os_RealToFloat(&l->elems[i]);
+}
+
+#endif
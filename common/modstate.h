@@ -0,0 +1,135 @@
+#ifndef COMMON_MODSTATE_H
+#define COMMON_MODSTATE_H
+
+#include <fileioc.h>
+#include <stdint.h>
+#include <string.h>
+#include "kinematics.h"
+
+// Solved states that other programs can read back. Each program writes its
+// packed state to an AppVar on exit. A reader copies the values it needs
+// straight out of the solved rows instead of re-entering and re-solving them.
+//
+// A program only starts from its own saved state when the launcher asks it
+// to: choosing resume in PHY2048 writes the program's state name to
+// RESUME_VAR before running it, and the program takes the request with
+// resumeRequested. Run any other way, or run from the launcher with enter, a
+// program starts from its defaults as it always has.
+
+#define MODSTATE_VERSION 2
+
+#define PROJ_STATE_VAR "PHYPROJ"
+#define OSC_STATE_VAR "PHYOSC"
+#define FORCE_STATE_VAR "PHYFORCE"
+#define MOM_STATE_VAR "PHYMOM"
+#define ROT_STATE_VAR "PHYROT"
+#define ORBIT_STATE_VAR "PHYORBIT"
+#define WORK_STATE_VAR "PHYWORK"
+#define MASS_STATE_VAR "PHYMASS"
+#define REL_STATE_VAR "PHYREL"
+#define VEC_STATE_VAR "PHYVEC"
+#define ROLL_STATE_VAR "PHYROLL"
+
+#define RESUME_VAR "PHYRESUM"
+
+#define EXTRA_COUNT 3
+#define EX_SPEED 0
+#define EX_ANGLE 1
+#define EX_VF 2
+
+// Everything autoSolve needs, with the known/user-set flags packed one bit per
+// row so a scenario can be copied or re-solved at another precision cheaply.
+template <typename T>
+struct ProjState {
+    T xVals[VAR_COUNT];
+    T yVals[VAR_COUNT];
+    T extraVals[EXTRA_COUNT];
+    uint8_t xSig[VAR_COUNT], ySig[VAR_COUNT], extraSig[EXTRA_COUNT];
+    uint8_t xKnown, yKnown, extraKnown;
+    uint8_t xUserSet, yUserSet, extraUserSet;
+};
+
+// The oscillations program keeps one of these per system, spring first.
+#define OSC_SYSTEMS 3
+#define OSC_MAX_VARS 12
+
+#define SP_M 0
+#define SP_K 1
+#define SP_W 2
+#define SP_F 3
+#define SP_T 4
+#define SP_A 5
+#define SP_VMAX 6
+#define SP_AMAX 7
+#define SP_E 8
+
+struct OscState {
+    float vals[OSC_MAX_VARS];
+    uint16_t known, userSet;
+};
+
+// A saved state is a list of chunks: the solved rows first, then whatever the
+// program needs to redraw as it was, such as its equation lists. Only the
+// first chunk's layout is shared, so other programs read just that one.
+struct ModChunk {
+    void* data;
+    uint16_t size;
+};
+
+// A one-byte version and the first chunk's size lead the data, so a state
+// written by an older build with a different layout is refused rather than
+// misread.
+inline bool saveModState(const char* name, const ModChunk* chunks, uint8_t count) {
+    uint8_t h = ti_Open(name, "w");
+    if (!h) return false;
+    uint8_t header[3] = {MODSTATE_VERSION, (uint8_t)(chunks[0].size & 0xFF), (uint8_t)(chunks[0].size >> 8)};
+    bool ok = ti_Write(header, sizeof(header), 1, h) == 1;
+    for (uint8_t i = 0; ok && i < count; i++) ok = ti_Write(chunks[i].data, chunks[i].size, 1, h) == 1;
+    ti_Close(h);
+    return ok;
+}
+
+// The size is checked up front, so a failed load leaves every chunk as it was.
+inline bool loadModState(const char* name, const ModChunk* chunks, uint8_t count) {
+    uint8_t h = ti_Open(name, "r");
+    if (!h) return false;
+    uint16_t total = 3;
+    for (uint8_t i = 0; i < count; i++) total += chunks[i].size;
+    uint8_t header[3];
+    bool ok = ti_GetSize(h) >= total && ti_Read(header, sizeof(header), 1, h) == 1 &&
+              header[0] == MODSTATE_VERSION && (header[1] | (header[2] << 8)) == chunks[0].size;
+    for (uint8_t i = 0; ok && i < count; i++) ok = ti_Read(chunks[i].data, chunks[i].size, 1, h) == 1;
+    ti_Close(h);
+    return ok;
+}
+
+inline bool requestResume(const char* name) {
+    uint8_t h = ti_Open(RESUME_VAR, "w");
+    if (!h) return false;
+    bool ok = ti_Write(name, strlen(name) + 1, 1, h) == 1;
+    ti_Close(h);
+    return ok;
+}
+
+// A request is good for one start: it is deleted here whoever it was for.
+inline bool resumeRequested(const char* name) {
+    char want[9] = "";
+    uint8_t h = ti_Open(RESUME_VAR, "r");
+    if (!h) return false;
+    ti_Read(want, 1, sizeof(want) - 1, h);
+    ti_Close(h);
+    ti_Delete(RESUME_VAR);
+    return !strcmp(want, name);
+}
+
+inline bool saveModState(const char* name, const void* data, uint16_t size) {
+    ModChunk chunk = {(void*)data, size};
+    return saveModState(name, &chunk, 1);
+}
+
+inline bool loadModState(const char* name, void* data, uint16_t size) {
+    ModChunk chunk = {data, size};
+    return loadModState(name, &chunk, 1);
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef COMMON_NUMFMT_H
+#define COMMON_NUMFMT_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define FMT_SIG_DIGITS 5
+#define FMT_MAX_LEN 8
+
+// Sig-fig count for values with no measured precision (defaults, zero).
+#define SIG_EXACT 0
+
+inline bool sigFigMode = false;
+
+template <typename T>
+T scalePow10(T v, int k) {
+    static const T pow10[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    while (k > 9) { v *= pow10[9]; k -= 9; }
+    while (k < -9) { v /= pow10[9]; k += 9; }
+    return (k >= 0) ? v * pow10[k] : v / pow10[-k];
+}
+
+template <typename T>
+int decExponent(T mag) {
+    int e = 0;
+    while (mag >= 1000000000) { mag /= 1000000000; e += 9; }
+    while (mag < 1) { mag *= 1000000000; e -= 9; }
+    T p = 10;
+    while (e < 1000 && mag >= p) { p *= 10; e++; }
+    return e;
+}
+
+inline int putExponent(char* out, int e) {
+    int len = 0;
+    if (e < 0) { out[len++] = '-'; e = -e; }
+    if (e >= 100) out[len++] = '0' + e / 100;
+    if (e >= 10) out[len++] = '0' + e / 10 % 10;
+    out[len++] = '0' + e % 10;
+    return len;
+}
+
+// Formats val with up to sigDigits significant digits in at most maxLen
+// characters, switching to engineering notation when plain notation won't fit.
+// Digits are dropped from the end until the result fits. U must hold
+// 10^sigDigits. Returns the length.
+template <typename T, typename U>
+int formatReal(T val, char* out, int sigDigits, int maxLen, bool trimZeros = true) {
+    int len = 0;
+    if (val != val) { strcpy(out, "?"); return 1; }
+    if (val < 0) { out[len++] = '-'; val = -val; }
+    if (val == 0) { strcpy(out, "0"); return 1; }
+    if (val * 0 != 0) { strcpy(out + len, "inf"); return len + 3; }
+
+    int maxSig = (sizeof(T) > sizeof(float)) ? 15 : 7;
+    if (sigDigits > maxSig) sigDigits = maxSig;
+    int e = decExponent(val);
+    char digits[16];
+    for (int sig = sigDigits; sig > 0; sig--) {
+        U lo = 1;
+        for (int i = 1; i < sig; i++) lo *= 10;
+        int exp10 = e;
+        U n = (U)(scalePow10(val, sig - 1 - exp10) + (T)0.5);
+        if (n < lo) {
+            exp10--;
+            n = (U)(scalePow10(val, sig - 1 - exp10) + (T)0.5);
+        }
+        if (n >= lo * 10) { n /= 10; exp10++; }
+
+        int nd = sig;
+        for (int i = sig - 1; i >= 0; i--) {
+            digits[i] = '0' + n % 10;
+            n /= 10;
+        }
+        while (trimZeros && nd > 1 && digits[nd - 1] == '0') nd--;
+
+        int fixedFrac = nd - 1 - exp10;
+        if (fixedFrac < 0) fixedFrac = 0;
+        int fixedLen = len + (exp10 >= 0 ? exp10 + 1 : 1) + (fixedFrac ? fixedFrac + 1 : 0);
+        if (exp10 >= -3 && exp10 < sigDigits && fixedLen <= maxLen) {
+            char* p = out + len;
+            int intDigits = exp10 >= 0 ? exp10 + 1 : 0;
+            for (int i = 0; i < intDigits; i++) *p++ = (i < nd) ? digits[i] : '0';
+            if (!intDigits) *p++ = '0';
+            if (fixedFrac) {
+                *p++ = '.';
+                for (int i = -1; i > exp10; i--) *p++ = '0';
+                for (int i = intDigits; i < nd; i++) *p++ = digits[i];
+            }
+            *p = '\0';
+            return p - out;
+        }
+
+        int engExp = (exp10 >= 0) ? exp10 - exp10 % 3 : -((2 - exp10) / 3) * 3;
+        int intDigits = exp10 - engExp + 1;
+        int frac = nd - intDigits;
+        if (frac < 0) frac = 0;
+        char expStr[5];
+        int expLen = putExponent(expStr, engExp);
+        if (len + intDigits + (frac ? frac + 1 : 0) + 1 + expLen <= maxLen || sig == 1) {
+            char* p = out + len;
+            for (int i = 0; i < intDigits; i++) *p++ = (i < nd) ? digits[i] : '0';
+            if (frac) {
+                *p++ = '.';
+                for (int i = intDigits; i < nd; i++) *p++ = digits[i];
+            }
+            *p++ = 'E';
+            for (int i = 0; i < expLen; i++) *p++ = expStr[i];
+            *p = '\0';
+            return p - out;
+        }
+    }
+    return 0;
+}
+
+inline int floatToStr(float val, char* out, int sigDigits = FMT_SIG_DIGITS) {
+    return formatReal<float, unsigned int>(val, out, sigDigits, FMT_MAX_LEN);
+}
+
+// In sig-fig mode a measured value keeps its trailing zeros, so 2.50 stays 2.50.
+inline int valueToStr(float val, uint8_t sig, char* out) {
+    if (!sigFigMode || sig == SIG_EXACT) return floatToStr(val, out);
+    return formatReal<float, unsigned int>(val, out, sig, FMT_MAX_LEN, false);
+}
+
+// Leading zeros never count; trailing zeros only count after a decimal point.
+inline uint8_t countSigFigs(const char* s) {
+    int digits = 0, trailingZeros = 0;
+    bool seenNonZero = false, hasPoint = false;
+    for (; *s; s++) {
+        if (*s == 'E') break;
+        if (*s == '.') { hasPoint = true; continue; }
+        if (*s < '0' || *s > '9') continue;
+        if (*s == '0' && !seenNonZero) continue;
+        seenNonZero = true;
+        digits++;
+        trailingZeros = (*s == '0') ? trailingZeros + 1 : 0;
+    }
+    if (!seenNonZero) return SIG_EXACT;
+    if (!hasPoint) digits -= trailingZeros;
+    return digits;
+}
+
+inline uint8_t sigMin(uint8_t a, uint8_t b) {
+    if (a == SIG_EXACT) return b;
+    if (b == SIG_EXACT) return a;
+    return a < b ? a : b;
+}
+
+// Addition rule: the result keeps digits down to the coarser of the two
+// operands' last significant decimal places.
+template <typename T>
+uint8_t sigSum(T result, T a, uint8_t sa, T b, uint8_t sb) {
+    if (sa == SIG_EXACT && sb == SIG_EXACT) return SIG_EXACT;
+    int place = -128;
+    if (sa != SIG_EXACT && a != 0) place = decExponent(a < 0 ? -a : a) - sa + 1;
+    if (sb != SIG_EXACT && b != 0) {
+        int pb = decExponent(b < 0 ? -b : b) - sb + 1;
+        if (pb > place) place = pb;
+    }
+    if (place == -128) return SIG_EXACT;
+    if (result == 0) return 1;
+    int sig = decExponent(result < 0 ? -result : result) - place + 1;
+    if (sig < 1) return 1;
+    return sig > 15 ? 15 : sig;
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef COMMON_PROPAGATE_H
+#define COMMON_PROPAGATE_H
+
+#include <math.h>
+#include <stdint.h>
+#include "kinematics.h"
+
+#define REL_MAX_TERMS 8
+
+#define REL_PRODUCT 0
+#define REL_SUM 1
+
+#define VBIT(i) ((uint32_t)1 << (i))
+
+// One equation among a module's variables, as data. A product relation reads
+//   v[var[0]] = coef[0] * v[var[1]]^pw[1] * v[var[2]]^pw[2] ...
+// and a sum relation reads
+//   coef[0]*v[var[0]] + coef[1]*v[var[1]] + ... = 0
+// Either one can be solved for whichever single member is still unknown.
+struct Relation {
+    uint8_t kind;
+    uint8_t n;
+    uint8_t var[REL_MAX_TERMS];
+    float coef[REL_MAX_TERMS];
+    int8_t pw[REL_MAX_TERMS];
+    const char* eq;
+};
+
+inline float powInt(float x, int p) {
+    float r = 1;
+    for (int i = 0; i < p; i++) r *= x;
+    return r;
+}
+
+// x with x^p = r. Even powers take the positive root, so a speed or a
+// stretch comes back as a magnitude.
+inline bool rootInt(float r, int p, float* x) {
+    if (p < 0) {
+        if (r == 0) return false;
+        r = 1 / r;
+        p = -p;
+    }
+    if (p == 1) {
+        *x = r;
+    } else if (p == 2) {
+        if (r < 0) return false;
+        *x = sqrtf(r);
+    } else {
+        if (r < 0 && !(p & 1)) return false;
+        *x = (r < 0) ? -powf(-r, 1.0f / p) : powf(r, 1.0f / p);
+    }
+    return true;
+}
+
+inline bool solveProduct(const Relation* rel, int k, const float* v, float* out) {
+    float rest = rel->coef[0];
+    for (int i = 1; i < rel->n; i++) {
+        if (i == k) continue;
+        int p = rel->pw[i];
+        float x = v[rel->var[i]];
+        if (p < 0) {
+            if (x == 0) return false;
+            rest /= powInt(x, -p);
+        } else {
+            rest *= powInt(x, p);
+        }
+    }
+    if (k == 0) {
+        *out = rest;
+        return true;
+    }
+    if (rest == 0) return false;
+    return rootInt(v[rel->var[0]] / rest, rel->pw[k], out);
+}
+
+inline bool solveSum(const Relation* rel, int k, const float* v, float* out) {
+    if (rel->coef[k] == 0) return false;
+    float sum = 0;
+    for (int i = 0; i < rel->n; i++) {
+        if (i != k) sum += rel->coef[i] * v[rel->var[i]];
+    }
+    *out = -sum / rel->coef[k];
+    return true;
+}
+
+// A product with a known zero factor is zero whatever the other factors are,
+// so Us = 1/2*k*x^2 at x = 0 needs no k.
+inline bool zeroFactor(const Relation* rel, const float* v, uint32_t known) {
+    if (rel->kind != REL_PRODUCT || (known & VBIT(rel->var[0]))) return false;
+    for (int i = 1; i < rel->n; i++) {
+        if (rel->pw[i] > 0 && (known & VBIT(rel->var[i])) && v[rel->var[i]] == 0) return true;
+    }
+    return false;
+}
+
+// Index of the one member of rel still unknown, or -1 if none or several are.
+inline int singleUnknown(const Relation* rel, uint32_t known) {
+    int unknown = -1;
+    for (int i = 0; i < rel->n; i++) {
+        if (known & VBIT(rel->var[i])) continue;
+        if (unknown >= 0) return -1;
+        unknown = i;
+    }
+    return unknown;
+}
+
+// Solves every relation left with exactly one unknown member, repeating until
+// a pass adds nothing, so a value found late still feeds the earlier rules.
+// Returns the bits of the variables it derived.
+template <typename Names = LinearNames>
+uint32_t propagate(const Relation* rels, int count, float* v, uint32_t* known, char* eqUsed) {
+    uint32_t derived = 0;
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (int r = 0; r < count; r++) {
+            const Relation* rel = &rels[r];
+            int k;
+            float val;
+            if (zeroFactor(rel, v, *known)) {
+                k = 0;
+                val = 0;
+            } else {
+                k = singleUnknown(rel, *known);
+                if (k < 0) continue;
+                bool ok = (rel->kind == REL_PRODUCT) ? solveProduct(rel, k, v, &val) : solveSum(rel, k, v, &val);
+                if (!ok) continue;
+            }
+            int i = rel->var[k];
+            v[i] = val;
+            *known |= VBIT(i);
+            derived |= VBIT(i);
+            addEq<Names>(eqUsed, rel->eq);
+            progress = true;
+        }
+    }
+    return derived;
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef COMMON_TABLEINPUT_H
+#define COMMON_TABLEINPUT_H
+
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include "numfmt.h"
+#include "ui.h"
+
+// The number being typed into a table cell.
+inline char inputBuf[12];
+inline int inputLen = 0;
+inline bool inputMode = false;
+inline bool hasDecimal = false;
+inline bool isNegative = false;
+inline bool hasExponent = false;
+
+inline void startInput() {
+    inputMode = true;
+    inputLen = 0;
+    inputBuf[0] = '\0';
+    hasDecimal = false;
+    isNegative = false;
+    hasExponent = false;
+}
+
+// The mantissa goes through the OS parser; an EE exponent is applied after.
+inline float parseInput() {
+    char fullStr[15];
+    if (isNegative) {
+        fullStr[0] = '-';
+        strcpy(fullStr + 1, inputBuf);
+    } else {
+        strcpy(fullStr, inputBuf);
+    }
+
+    int exp10 = 0;
+    char* ee = strchr(fullStr, 'E');
+    if (ee) {
+        *ee = '\0';
+        bool negExp = ee[1] == '-';
+        for (const char* p = ee + (negExp ? 2 : 1); *p; p++) exp10 = exp10 * 10 + (*p - '0');
+        if (negExp) exp10 = -exp10;
+    }
+
+    char* end;
+    real_t r = os_StrToReal(fullStr, &end);
+    return scalePow10(os_RealToFloat(&r), exp10);
+}
+
+inline void readDigitKeys(bool keys[10]) {
+    keys[0] = kb_Data[3] & kb_0;
+    keys[1] = kb_Data[3] & kb_1;
+    keys[2] = kb_Data[4] & kb_2;
+    keys[3] = kb_Data[5] & kb_3;
+    keys[4] = kb_Data[3] & kb_4;
+    keys[5] = kb_Data[4] & kb_5;
+    keys[6] = kb_Data[5] & kb_6;
+    keys[7] = kb_Data[3] & kb_7;
+    keys[8] = kb_Data[4] & kb_8;
+    keys[9] = kb_Data[5] & kb_9;
+}
+
+// Starts an entry if a digit, (-) or . was just pressed.
+inline bool startInputFromKeys(const bool* digitPressed, bool negPressed, bool dotPressed) {
+    for (int i = 0; i <= 9; i++) {
+        if (digitPressed[i]) {
+            startInput();
+            inputBuf[0] = '0' + i;
+            inputBuf[1] = '\0';
+            inputLen = 1;
+            return true;
+        }
+    }
+    if (negPressed) {
+        startInput();
+        isNegative = true;
+        return true;
+    }
+    if (dotPressed) {
+        startInput();
+        inputBuf[0] = '.';
+        inputBuf[1] = '\0';
+        inputLen = 1;
+        hasDecimal = true;
+        return true;
+    }
+    return false;
+}
+
+// After [EE], (-) flips the exponent's sign instead of the number's.
+inline void typeInputKeys(const bool* digitPressed, bool negPressed, bool dotPressed, bool delPressed, bool eePressed = false) {
+    char* ee = strchr(inputBuf, 'E');
+    for (int i = 0; i <= 9; i++) {
+        if (digitPressed[i] && inputLen < 10 && !(ee && strlen(ee) - (ee[1] == '-') > 2)) {
+            inputBuf[inputLen++] = '0' + i;
+            inputBuf[inputLen] = '\0';
+        }
+    }
+
+    if (dotPressed && !hasDecimal && !hasExponent && inputLen < 10) {
+        inputBuf[inputLen++] = '.';
+        inputBuf[inputLen] = '\0';
+        hasDecimal = true;
+    }
+
+    if (eePressed && !hasExponent && inputLen > 0 && inputLen < 9) {
+        inputBuf[inputLen++] = 'E';
+        inputBuf[inputLen] = '\0';
+        hasExponent = true;
+        ee = inputBuf + inputLen - 1;
+    }
+
+    if (negPressed && hasExponent) {
+        if (ee[1] == '-') {
+            memmove(ee + 1, ee + 2, strlen(ee + 2) + 1);
+            inputLen--;
+        } else if (inputLen < 10) {
+            memmove(ee + 2, ee + 1, strlen(ee + 1) + 1);
+            ee[1] = '-';
+            inputLen++;
+        }
+    } else if (negPressed) {
+        isNegative = !isNegative;
+    }
+
+    if (delPressed && inputLen > 0) {
+        inputLen--;
+        if (inputBuf[inputLen] == '.') hasDecimal = false;
+        if (inputBuf[inputLen] == 'E') hasExponent = false;
+        inputBuf[inputLen] = '\0';
+    }
+}
+
+inline void cancelInput() {
+    inputMode = false;
+}
+
+inline void inputText(char* out) {
+    if (isNegative && inputLen > 0) {
+        out[0] = '-';
+        strcpy(out + 1, inputBuf);
+    } else if (isNegative) {
+        strcpy(out, "-");
+    } else if (inputLen == 0) {
+        strcpy(out, "_");
+    } else {
+        strcpy(out, inputBuf);
+    }
+}
+
+#endif
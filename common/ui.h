@@ -0,0 +1,40 @@
+#ifndef COMMON_UI_H
+#define COMMON_UI_H
+
+#include <graphx.h>
+#include <keypadc.h>
+#include <string.h>
+
+inline void waitKeyRelease() {
+    while (kb_AnyKey()) kb_Scan();
+}
+
+// A full-screen notice that waits for a key.
+inline void drawMessage(const char* msg) {
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(224);
+    gfx_PrintStringXY(msg, 20, 100);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("Any key to return", 101, 225);
+    gfx_BlitBuffer();
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+// Prints a '|'-separated equation list one per line from y, stopping before
+// yMax. Returns the y below the last line.
+inline int printEqList(const char* list, int y, int yMax = 230) {
+    while (*list && y < yMax) {
+        const char* end = strchr(list, '|');
+        int len = end ? end - list : strlen(list);
+        char eq[64];
+        strncpy(eq, list, len);
+        eq[len] = '\0';
+        gfx_PrintStringXY(eq, 5, y);
+        y += 10;
+        list += end ? len + 1 : len;
+    }
+    return y;
+}
+
+#endif
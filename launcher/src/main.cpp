@@ -0,0 +1,184 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <fileioc.h>
+#include <string.h>
+
+#include "modstate.h"
+#include "ui.h"
+
+#define LAUNCH_STATE_VAR "PHYLAUNC"
+
+#define MODULE_COUNT 11
+#define NO_MODULE 0xFF
+
+// Saved states of this many recently run modules stay in RAM; the rest are
+// archived so the module being run has the free RAM to itself.
+#define RECENT_KEEP 2
+
+struct Module {
+    const char* prgm;
+    const char* title;
+    const char* stateVar;
+};
+
+const Module modules[MODULE_COUNT] = {
+    {"FORCES", "Newton's Laws", FORCE_STATE_VAR},
+    {"PROJMOT", "Projectile Motion", PROJ_STATE_VAR},
+    {"MOMENTUM", "Momentum and Collisions", MOM_STATE_VAR},
+    {"ROTMOT", "Rotational Motion", ROT_STATE_VAR},
+    {"OSCMOT", "Oscillations", OSC_STATE_VAR},
+    {"ORBIT", "Orbits and Gravitation", ORBIT_STATE_VAR},
+    {"WORKEN", "Work, Energy and Power", WORK_STATE_VAR},
+    {"MASSDIST", "Center of Mass", MASS_STATE_VAR},
+    {"RELVEL", "Relative Velocity", REL_STATE_VAR},
+    {"VECSUM", "Vector Sum", VEC_STATE_VAR},
+    {"ROLLING", "Rolling Motion", ROLL_STATE_VAR}
+};
+
+struct LaunchState {
+    uint8_t recent[RECENT_KEEP];
+};
+
+LaunchState ls;
+bool saved[MODULE_COUNT];
+int curRow = 0;
+
+bool isRecent(int m) {
+    for (int i = 0; i < RECENT_KEEP; i++) {
+        if (ls.recent[i] == m) return true;
+    }
+    return false;
+}
+
+bool hasState(int m) {
+    uint8_t h = ti_Open(modules[m].stateVar, "r");
+    if (!h) return false;
+    ti_Close(h);
+    return true;
+}
+
+void markRecent(int m) {
+    int i = 0;
+    while (i < RECENT_KEEP - 1 && ls.recent[i] != m) i++;
+    for (; i > 0; i--) ls.recent[i] = ls.recent[i - 1];
+    ls.recent[0] = (uint8_t)m;
+}
+
+// Moves each saved state to RAM or archive to match the recent list.
+void placeStates() {
+    for (int m = 0; m < MODULE_COUNT; m++) {
+        uint8_t h = ti_Open(modules[m].stateVar, "r");
+        if (!h) continue;
+        ti_SetArchiveStatus(!isRecent(m), h);
+        ti_Close(h);
+    }
+}
+
+void drawMenu() {
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("PHY2048 - Evan Kolberg", 80, 3);
+
+    int startX = 5;
+    int startY = 16;
+    int rowH = 15;
+
+    for (int m = 0; m < MODULE_COUNT; m++) {
+        int y = startY + m * rowH;
+        if (m == curRow) {
+            gfx_SetColor(183);
+            gfx_FillRectangle(startX, y, 310, rowH - 1);
+        }
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(modules[m].prgm, startX + 3, y + 3);
+        gfx_PrintStringXY(modules[m].title, startX + 72, y + 3);
+        if (saved[m]) {
+            gfx_SetTextFGColor(24);
+            gfx_PrintStringXY("saved", startX + 262, y + 3);
+        }
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("enter: run  graph: resume  clear: quit", 8, 225);
+}
+
+int runMenu();
+
+// The OS drops the launcher while a module runs and reloads it afterwards,
+// so only one program is in RAM at a time.
+int returnToMenu(void* data, int retval) {
+    (void)data;
+    (void)retval;
+    return runMenu();
+}
+
+// Enter starts a module from its defaults; graph has it pick up its saved
+// state.
+void runModule(int m, bool resume) {
+    markRecent(m);
+    saveModState(LAUNCH_STATE_VAR, &ls, sizeof(ls));
+    if (resume) requestResume(modules[m].stateVar);
+    else ti_Delete(RESUME_VAR);
+    gfx_End();
+    // Archiving can set off a garbage collect, which draws on the
+    // screen, so it waits until graphx has let go.
+    placeStates();
+    os_RunPrgm(modules[m].prgm, NULL, 0, returnToMenu);
+
+    // Only reached when the module could not be started.
+    ti_Delete(RESUME_VAR);
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+    drawMessage("Module not found");
+}
+
+int runMenu() {
+    memset(&ls, NO_MODULE, sizeof(ls));
+    loadModState(LAUNCH_STATE_VAR, &ls, sizeof(ls));
+    curRow = (ls.recent[0] < MODULE_COUNT) ? ls.recent[0] : 0;
+    for (int m = 0; m < MODULE_COUNT; m++) saved[m] = hasState(m);
+
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    // The key that closed the module may still be held.
+    waitKeyRelease();
+
+    bool prevUp = false, prevDown = false, prevEnter = false, prevGraph = false, prevClear = false;
+    while (true) {
+        drawMenu();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool clear = kb_Data[6] & kb_Clear;
+
+        if (up && !prevUp) curRow = (curRow + MODULE_COUNT - 1) % MODULE_COUNT;
+        if (down && !prevDown) curRow = (curRow + 1) % MODULE_COUNT;
+        if (clear && !prevClear) break;
+
+        if (enter && !prevEnter) {
+            runModule(curRow, false);
+            enter = false;
+        } else if (graph && !prevGraph && saved[curRow]) {
+            runModule(curRow, true);
+            graph = false;
+        }
+
+        prevUp = up; prevDown = down; prevEnter = enter; prevGraph = graph; prevClear = clear;
+    }
+
+    gfx_End();
+    return 0;
+}
+
+int main(void) {
+    return runMenu();
+}
@@ -0,0 +1,716 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define PI 3.14159265f
+#define DEG_TO_RAD (PI / 180.0f)
+#define RAD_TO_DEG (180.0f / PI)
+
+#define SYS_LINE 0
+#define SYS_PLANE 1
+#define SYS_COUNT 2
+
+#define COL_MAX_VARS 12
+
+#define L_M1 0
+#define L_M2 1
+#define L_U1 2
+#define L_U2 3
+#define L_V1 4
+#define L_V2 5
+#define L_E 6
+#define L_P 7
+#define L_DK 8
+
+#define P_M1 0
+#define P_M2 1
+#define P_U1 2
+#define P_A1 3
+#define P_U2 4
+#define P_A2 5
+#define P_E 6
+#define P_PHI 7
+#define P_V1 8
+#define P_B1 9
+#define P_V2 10
+#define P_B2 11
+
+#define BALL_MAX 8
+#define LINE_BALLS 5
+#define BOX_BALLS 8
+#define EVENT_MAX 128
+#define EVENTS_PER_FRAME 200
+#define FRAME_DT (1 / 30.0f)
+#define SIM_SPEED 60.0f
+#define CONTACT_GAP 0.05f
+
+#define WALL_X -1
+#define WALL_Y -2
+
+struct CollState {
+    float vals[COL_MAX_VARS];
+    uint16_t known, userSet;
+};
+
+CollState systems[SYS_COUNT];
+int curSys = SYS_LINE;
+
+int curRow = 0;
+
+const char* colTitles[SYS_COUNT] = {"1-D COLLISION", "2-D COLLISION"};
+const int colRows[SYS_COUNT] = {9, 12};
+const char* colLabels[SYS_COUNT][COL_MAX_VARS] = {
+    {"m1", "m2", "u1", "u2", "v1", "v2", "e", "p", "K lost"},
+    {"m1", "m2", "u1", "th1", "u2", "th2", "e", "phi", "v1", "th1f", "v2", "th2f"}
+};
+const char* colUnits[SYS_COUNT][COL_MAX_VARS] = {
+    {"kg", "kg", "m/s", "m/s", "m/s", "m/s", "", "kg*m/s", "J"},
+    {"kg", "kg", "m/s", "deg", "m/s", "deg", "", "deg", "m/s", "deg", "m/s", "deg"}
+};
+
+char eqUsed[64] = "";
+
+void initData() {
+    memset(systems, 0, sizeof(systems));
+    CollState& l = systems[SYS_LINE];
+    l.vals[L_E] = 1;
+    l.known = l.userSet = BIT(L_E);
+    CollState& p = systems[SYS_PLANE];
+    p.vals[P_E] = 1;
+    p.known = p.userSet = BIT(P_E) | BIT(P_PHI);
+}
+
+bool isKnown(const CollState& s, int i) {
+    return s.known & BIT(i);
+}
+
+void derive(CollState& s, int i, float val, const char* eq) {
+    s.vals[i] = val;
+    s.known |= BIT(i);
+    addEq(eqUsed, eq);
+}
+
+// Momentum and restitution are both linear in (u1, u2, v1, v2):
+//   m1*u1 + m2*u2 - m1*v1 - m2*v2 = 0
+//   e*u1  - e*u2  + v1    - v2    = 0
+// so one unknown velocity comes from either row and two from the pair.
+void solveLine(CollState& s) {
+    float* v = s.vals;
+    const int vel[4] = {L_U1, L_U2, L_V1, L_V2};
+    const char* momEq = "m1*u1 + m2*u2 = m1*v1 + m2*v2";
+    const char* resEq = "v2 - v1 = e*(u1 - u2)";
+    for (int iter = 0; iter < 3; iter++) {
+        bool masses = isKnown(s, L_M1) && isKnown(s, L_M2);
+        bool hasE = isKnown(s, L_E);
+        float mom[4] = {v[L_M1], v[L_M2], -v[L_M1], -v[L_M2]};
+        float res[4] = {v[L_E], -v[L_E], 1, -1};
+        float momRhs = 0, resRhs = 0;
+        int unknown[4], n = 0;
+        for (int i = 0; i < 4; i++) {
+            if (isKnown(s, vel[i])) {
+                momRhs -= mom[i] * v[vel[i]];
+                resRhs -= res[i] * v[vel[i]];
+            } else {
+                unknown[n++] = i;
+            }
+        }
+
+        if (n == 1) {
+            int k = unknown[0];
+            if (masses && mom[k] != 0) derive(s, vel[k], momRhs / mom[k], momEq);
+            else if (hasE && res[k] != 0) derive(s, vel[k], resRhs / res[k], resEq);
+        } else if (n == 2 && masses && hasE) {
+            int a = unknown[0], b = unknown[1];
+            float det = mom[a] * res[b] - mom[b] * res[a];
+            if (det != 0) {
+                derive(s, vel[a], (momRhs * res[b] - mom[b] * resRhs) / det, momEq);
+                derive(s, vel[b], (mom[a] * resRhs - momRhs * res[a]) / det, resEq);
+            }
+        }
+
+        bool allVel = isKnown(s, L_U1) && isKnown(s, L_U2) && isKnown(s, L_V1) && isKnown(s, L_V2);
+        if (!allVel) continue;
+        if (!hasE && v[L_U1] != v[L_U2]) {
+            derive(s, L_E, (v[L_V2] - v[L_V1]) / (v[L_U1] - v[L_U2]), resEq);
+        }
+        if (!isKnown(s, L_M1) && isKnown(s, L_M2) && v[L_U1] != v[L_V1]) {
+            derive(s, L_M1, v[L_M2] * (v[L_V2] - v[L_U2]) / (v[L_U1] - v[L_V1]), momEq);
+        }
+        if (!isKnown(s, L_M2) && isKnown(s, L_M1) && v[L_U2] != v[L_V2]) {
+            derive(s, L_M2, v[L_M1] * (v[L_U1] - v[L_V1]) / (v[L_V2] - v[L_U2]), momEq);
+        }
+        if (isKnown(s, L_M1) && isKnown(s, L_M2)) {
+            if (!isKnown(s, L_P)) derive(s, L_P, v[L_M1] * v[L_U1] + v[L_M2] * v[L_U2], "p = m1*u1 + m2*u2");
+            if (!isKnown(s, L_DK)) {
+                float ki = v[L_M1] * v[L_U1] * v[L_U1] + v[L_M2] * v[L_U2] * v[L_U2];
+                float kf = v[L_M1] * v[L_V1] * v[L_V1] + v[L_M2] * v[L_V2] * v[L_V2];
+                derive(s, L_DK, 0.5f * (ki - kf), "K lost = Ki - Kf");
+            }
+        }
+    }
+}
+
+// Frictionless spheres: only the components along the line of centers (at
+// angle phi) change, exactly as in 1-D; the tangential parts pass through.
+void solvePlane(CollState& s) {
+    float* v = s.vals;
+    for (int i = P_M1; i <= P_PHI; i++) {
+        if (!isKnown(s, i)) return;
+    }
+    float m1 = v[P_M1], m2 = v[P_M2], e = v[P_E];
+    if (m1 + m2 <= 0) return;
+    float phi = v[P_PHI] * DEG_TO_RAD;
+    float a1 = v[P_A1] * DEG_TO_RAD - phi, a2 = v[P_A2] * DEG_TO_RAD - phi;
+    float u1n = v[P_U1] * cosf(a1), u1t = v[P_U1] * sinf(a1);
+    float u2n = v[P_U2] * cosf(a2), u2t = v[P_U2] * sinf(a2);
+    float p = m1 * u1n + m2 * u2n;
+    float v1n = (p + m2 * e * (u2n - u1n)) / (m1 + m2);
+    float v2n = (p + m1 * e * (u1n - u2n)) / (m1 + m2);
+
+    const char* eq = "v2n - v1n = e*(u1n - u2n)";
+    if (!isKnown(s, P_V1)) derive(s, P_V1, sqrtf(v1n * v1n + u1t * u1t), eq);
+    if (!isKnown(s, P_B1)) derive(s, P_B1, (phi + atan2f(u1t, v1n)) * RAD_TO_DEG, eq);
+    if (!isKnown(s, P_V2)) derive(s, P_V2, sqrtf(v2n * v2n + u2t * u2t), eq);
+    if (!isKnown(s, P_B2)) derive(s, P_B2, (phi + atan2f(u2t, v2n)) * RAD_TO_DEG, eq);
+    addEq(eqUsed, "tangent parts unchanged");
+}
+
+void autoSolve() {
+    CollState& s = systems[curSys];
+    eqUsed[0] = '\0';
+    s.known &= s.userSet;
+    if (curSys == SYS_LINE) solveLine(s);
+    else solvePlane(s);
+}
+
+void setCell(int row, bool set, float val) {
+    CollState& s = systems[curSys];
+    s.vals[row] = set ? val : 0;
+    if (set) {
+        s.known |= BIT(row);
+        s.userSet |= BIT(row);
+    } else {
+        s.known &= ~BIT(row);
+        s.userSet &= ~BIT(row);
+    }
+}
+
+struct Ball {
+    float x, y, vx, vy;
+    float m, r;
+    uint16_t count;
+};
+
+// A predicted collision of ball a with ball b or a wall. It is stale once
+// either ball has collided since it was predicted.
+struct Event {
+    float t;
+    int8_t a, b;
+    uint16_t countA, countB;
+};
+
+struct BallSim {
+    Ball balls[BALL_MAX];
+    int count;
+    float left, right, top, bottom;
+    float t, e;
+    Event heap[EVENT_MAX];
+    int heapSize;
+    uint32_t events;
+};
+
+BallSim sim;
+
+uint32_t xorshift32(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+void heapPush(BallSim* s, float t, int a, int b) {
+    if (s->heapSize == EVENT_MAX) return;
+    Event ev;
+    ev.t = t;
+    ev.a = a;
+    ev.b = b;
+    ev.countA = s->balls[a].count;
+    ev.countB = (b >= 0) ? s->balls[b].count : 0;
+    int i = s->heapSize++;
+    while (i > 0 && s->heap[(i - 1) / 2].t > t) {
+        s->heap[i] = s->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    s->heap[i] = ev;
+}
+
+Event heapPop(BallSim* s) {
+    Event top = s->heap[0];
+    Event last = s->heap[--s->heapSize];
+    int i = 0;
+    for (;;) {
+        int c = 2 * i + 1;
+        if (c >= s->heapSize) break;
+        if (c + 1 < s->heapSize && s->heap[c + 1].t < s->heap[c].t) c++;
+        if (s->heap[c].t >= last.t) break;
+        s->heap[i] = s->heap[c];
+        i = c;
+    }
+    s->heap[i] = last;
+    return top;
+}
+
+bool eventValid(const BallSim* s, const Event* ev) {
+    if (s->balls[ev->a].count != ev->countA) return false;
+    return ev->b < 0 || s->balls[ev->b].count == ev->countB;
+}
+
+// Time until balls i and j touch, or -1 if they never do on current paths.
+float pairTime(const Ball* p, const Ball* q) {
+    float dx = q->x - p->x, dy = q->y - p->y;
+    float dvx = q->vx - p->vx, dvy = q->vy - p->vy;
+    float dvdr = dx * dvx + dy * dvy;
+    if (dvdr >= 0) return -1;
+    float dvdv = dvx * dvx + dvy * dvy;
+    float sigma = p->r + q->r;
+    float d = dvdr * dvdr - dvdv * (dx * dx + dy * dy - sigma * sigma);
+    if (d < 0) return -1;
+    float t = -(dvdr + sqrtf(d)) / dvdv;
+    return (t < 0) ? 0 : t;
+}
+
+// A ball already past a wall, e.g. after being pushed out of an overlap,
+// reflects right away instead of at a time in the past.
+void pushWall(BallSim* s, float dt, int i, int wall) {
+    heapPush(s, s->t + ((dt > 0) ? dt : 0), i, wall);
+}
+
+void predictWalls(BallSim* s, int i) {
+    const Ball* p = &s->balls[i];
+    if (p->vx > 0) pushWall(s, (s->right - p->r - p->x) / p->vx, i, WALL_X);
+    if (p->vx < 0) pushWall(s, (s->left + p->r - p->x) / p->vx, i, WALL_X);
+    if (p->vy > 0) pushWall(s, (s->bottom - p->r - p->y) / p->vy, i, WALL_Y);
+    if (p->vy < 0) pushWall(s, (s->top + p->r - p->y) / p->vy, i, WALL_Y);
+}
+
+void predict(BallSim* s, int i) {
+    predictWalls(s, i);
+    for (int j = 0; j < s->count; j++) {
+        if (j == i) continue;
+        float dt = pairTime(&s->balls[i], &s->balls[j]);
+        if (dt >= 0) heapPush(s, s->t + dt, i, j);
+    }
+}
+
+// Stale events pile up in the heap; when it runs short of room, start over
+// from the current positions.
+void predictAll(BallSim* s) {
+    s->heapSize = 0;
+    for (int i = 0; i < s->count; i++) {
+        predictWalls(s, i);
+        for (int j = i + 1; j < s->count; j++) {
+            float dt = pairTime(&s->balls[i], &s->balls[j]);
+            if (dt >= 0) heapPush(s, s->t + dt, i, j);
+        }
+    }
+}
+
+void moveBalls(BallSim* s, float t) {
+    float dt = t - s->t;
+    for (int i = 0; i < s->count; i++) {
+        s->balls[i].x += s->balls[i].vx * dt;
+        s->balls[i].y += s->balls[i].vy * dt;
+    }
+    s->t = t;
+}
+
+void keepInside(const BallSim* s, Ball* p) {
+    if (p->x < s->left + p->r) p->x = s->left + p->r;
+    if (p->x > s->right - p->r) p->x = s->right - p->r;
+    if (p->y < s->top + p->r) p->y = s->top + p->r;
+    if (p->y > s->bottom - p->r) p->y = s->bottom - p->r;
+}
+
+// Impulse along the line of centers, J = (1 + e) m1 m2 (dv.dr) / (m1 + m2) |dr|.
+// Returns false for a pair that is already moving apart, so the event is stale.
+// With e < 1 a touching cluster would otherwise collide again at zero gap
+// without end, so the pair is left CONTACT_GAP apart, the lighter ball moving
+// the farther.
+bool bounce(BallSim* s, Ball* p, Ball* q) {
+    float dx = q->x - p->x, dy = q->y - p->y;
+    float dvdr = dx * (q->vx - p->vx) + dy * (q->vy - p->vy);
+    if (dvdr >= 0) return false;
+    float dist = sqrtf(dx * dx + dy * dy);
+    float j = (1 + s->e) * p->m * q->m * dvdr / ((p->m + q->m) * dist);
+    float nx = dx / dist, ny = dy / dist;
+    p->vx += j * nx / p->m;
+    p->vy += j * ny / p->m;
+    q->vx -= j * nx / q->m;
+    q->vy -= j * ny / q->m;
+
+    float overlap = p->r + q->r + CONTACT_GAP - dist;
+    if (overlap > 0) {
+        float fp = q->m / (p->m + q->m);
+        p->x -= overlap * fp * nx;
+        p->y -= overlap * fp * ny;
+        q->x += overlap * (1 - fp) * nx;
+        q->y += overlap * (1 - fp) * ny;
+        keepInside(s, p);
+        keepInside(s, q);
+    }
+    return true;
+}
+
+// Processes every event up to time t, then moves the balls to t in closed form.
+// If a burst of events hits the per-frame cap, the frame stops at the next
+// pending event so nothing passes through; the clock just runs slow.
+void advanceSim(BallSim* s, float t) {
+    for (int n = 0; n < EVENTS_PER_FRAME && s->heapSize > 0 && s->heap[0].t <= t; n++) {
+        Event ev = heapPop(s);
+        if (!eventValid(s, &ev)) continue;
+        moveBalls(s, ev.t);
+        Ball* p = &s->balls[ev.a];
+        if (ev.b == WALL_X) p->vx = -p->vx;
+        else if (ev.b == WALL_Y) p->vy = -p->vy;
+        else if (!bounce(s, p, &s->balls[ev.b])) continue;
+        p->count++;
+        if (ev.b >= 0) s->balls[ev.b].count++;
+        s->events++;
+
+        if (s->heapSize > EVENT_MAX - 2 * (BALL_MAX + 4)) {
+            predictAll(s);
+        } else {
+            predict(s, ev.a);
+            if (ev.b >= 0) predict(s, ev.b);
+        }
+    }
+    if (s->heapSize > 0 && s->heap[0].t < t) t = s->heap[0].t;
+    if (t > s->t) moveBalls(s, t);
+}
+
+float simEnergy(const BallSim* s) {
+    float k = 0;
+    for (int i = 0; i < s->count; i++) {
+        const Ball* p = &s->balls[i];
+        k += 0.5f * p->m * (p->vx * p->vx + p->vy * p->vy);
+    }
+    return k;
+}
+
+float randUnit(uint32_t* rng) {
+    return (xorshift32(rng) & 0xFFFF) / 65535.0f;
+}
+
+bool placeBall(BallSim* s, int i, float m, float r, float vx, float vy, uint32_t* rng) {
+    Ball* p = &s->balls[i];
+    p->m = m;
+    p->r = r;
+    p->vx = vx;
+    p->vy = vy;
+    p->count = 0;
+    for (int tries = 0; tries < 50; tries++) {
+        p->x = s->left + p->r + randUnit(rng) * (s->right - s->left - 2 * p->r);
+        p->y = (s->top + s->bottom) / 2;
+        if (curSys == SYS_PLANE) p->y = s->top + p->r + randUnit(rng) * (s->bottom - s->top - 2 * p->r);
+        bool clear = true;
+        for (int j = 0; j < i; j++) {
+            const Ball* q = &s->balls[j];
+            float dx = q->x - p->x, dy = q->y - p->y;
+            if (dx * dx + dy * dy < (p->r + q->r + 2) * (p->r + q->r + 2)) clear = false;
+        }
+        if (clear) return true;
+    }
+    return false;
+}
+
+// Balls 1 and 2 take the table's masses and initial velocities when they are
+// set; the rest are random. Speeds are scaled so the fastest moves SIM_SPEED
+// pixels per second, and the heaviest ball gets the largest radius.
+void initSim(BallSim* s) {
+    static uint32_t rng;
+    if (!rng) rng = rtc_Time() | 1;
+    const CollState& c = systems[curSys];
+    const float* v = c.vals;
+    bool line = curSys == SYS_LINE;
+
+    s->left = 10;
+    s->right = 310;
+    s->top = line ? 100 : 26;
+    s->bottom = line ? 140 : 214;
+    s->t = 0;
+    s->events = 0;
+    s->e = isKnown(c, line ? L_E : P_E) ? v[line ? L_E : P_E] : 1;
+    if (s->e < 0) s->e = 0;
+    if (s->e > 1) s->e = 1;
+
+    float m[BALL_MAX], vx[BALL_MAX], vy[BALL_MAX];
+    int n = line ? LINE_BALLS : BOX_BALLS;
+    for (int i = 0; i < n; i++) {
+        m[i] = 0.5f + 1.5f * randUnit(&rng);
+        float ang = 2 * PI * randUnit(&rng);
+        vx[i] = line ? 2 * randUnit(&rng) - 1 : cosf(ang);
+        vy[i] = line ? 0 : sinf(ang);
+    }
+    int mRow[2] = {L_M1, L_M2}, uRow[2] = {L_U1, L_U2};
+    int aRow[2] = {P_A1, P_A2}, pRow[2] = {P_U1, P_U2};
+    for (int i = 0; i < 2; i++) {
+        if (!isKnown(c, mRow[i]) || !isKnown(c, line ? uRow[i] : pRow[i])) continue;
+        m[i] = v[mRow[i]];
+        if (line) {
+            vx[i] = v[uRow[i]];
+        } else if (isKnown(c, aRow[i])) {
+            vx[i] = v[pRow[i]] * cosf(v[aRow[i]] * DEG_TO_RAD);
+            vy[i] = -v[pRow[i]] * sinf(v[aRow[i]] * DEG_TO_RAD);
+        }
+    }
+
+    float mMax = 0, vMax = 0;
+    for (int i = 0; i < n; i++) {
+        if (m[i] > mMax) mMax = m[i];
+        float sp = sqrtf(vx[i] * vx[i] + vy[i] * vy[i]);
+        if (sp > vMax) vMax = sp;
+    }
+    if (mMax <= 0) mMax = 1;
+    float vk = (vMax > 0) ? SIM_SPEED / vMax : 1;
+
+    s->count = 0;
+    for (int i = 0; i < n; i++) {
+        if (m[i] <= 0) continue;
+        float r = 4 + 6 * sqrtf(m[i] / mMax);
+        if (placeBall(s, s->count, m[i], r, vx[i] * vk, vy[i] * vk, &rng)) s->count++;
+    }
+    if (line) {
+        for (int i = 1; i < s->count; i++) {
+            Ball b = s->balls[i];
+            int j = i - 1;
+            while (j >= 0 && s->balls[j].x > b.x) {
+                s->balls[j + 1] = s->balls[j];
+                j--;
+            }
+            s->balls[j + 1] = b;
+        }
+    }
+    predictAll(s);
+}
+
+void drawSim(const BallSim* s, float k0) {
+    char buf[15];
+    gfx_FillScreen(255);
+    gfx_SetColor(0);
+    gfx_Rectangle((int)s->left - 1, (int)s->top - 1, (int)(s->right - s->left) + 2, (int)(s->bottom - s->top) + 2);
+    const uint8_t colors[BALL_MAX] = {224, 24, 7, 227, 160, 100, 148, 30};
+    for (int i = 0; i < s->count; i++) {
+        const Ball* p = &s->balls[i];
+        gfx_SetColor(colors[i]);
+        gfx_FillCircle((int)p->x, (int)p->y, (int)p->r);
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("t:", 2, 2);
+    floatToStr(s->t, buf);
+    gfx_PrintStringXY(buf, 20, 2);
+    gfx_PrintStringXY("events:", 110, 2);
+    floatToStr((float)s->events, buf);
+    gfx_PrintStringXY(buf, 168, 2);
+    gfx_PrintStringXY("K/K0:", 226, 2);
+    floatToStr(k0 > 0 ? simEnergy(s) / k0 : 0, buf, 3);
+    gfx_PrintStringXY(buf, 268, 2);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("enter: restart  clear: return", 40, 228);
+}
+
+// Jumps from collision to collision with no time stepping in between; the
+// frames only sample the straight-line motion between events.
+void runSim() {
+    initSim(&sim);
+    float k0 = simEnergy(&sim);
+    bool running = true;
+    while (running) {
+        advanceSim(&sim, sim.t + FRAME_DT);
+        drawSim(&sim, k0);
+        gfx_BlitBuffer();
+
+        kb_Scan();
+        if (kb_Data[6] & kb_Clear) running = false;
+        if (kb_Data[6] & kb_Enter) {
+            initSim(&sim);
+            k0 = simEnergy(&sim);
+            waitKeyRelease();
+        }
+    }
+    waitKeyRelease();
+}
+
+void drawTable() {
+    const CollState& s = systems[curSys];
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("MOMENTUM - Evan Kolberg", 76, 3);
+
+    int startX = 5;
+    int startY = 16;
+    int rowH = 15;
+    int labelW = 52;
+    int boxW = 84;
+
+    for (int row = 0; row < colRows[curSys]; row++) {
+        int y = startY + row * rowH;
+        bool selected = (row == curRow && !inputMode);
+        bool editing = (row == curRow && inputMode);
+        int x = startX + labelW;
+
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(colLabels[curSys][row], startX + 2, y + 3);
+
+        if (selected) {
+            gfx_SetColor(183);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        } else if (editing) {
+            gfx_SetColor(239);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        }
+        gfx_SetColor(0);
+        gfx_Rectangle(x, y, boxW, rowH - 2);
+
+        char buf[15];
+        if (editing) {
+            inputText(buf);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else if (isKnown(s, row)) {
+            floatToStr(s.vals[row], buf);
+            gfx_SetTextFGColor((s.userSet & BIT(row)) ? 0 : 24);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else {
+            gfx_PrintStringXY("?", x + boxW / 2 - 4, y + 3);
+        }
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(colUnits[curSys][row], x + boxW + 4, y + 3);
+    }
+
+    int rightX = 196;
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY(colTitles[curSys], rightX, startY + 3);
+    int eRow = (curSys == SYS_LINE) ? L_E : P_E;
+    if (isKnown(s, eRow)) {
+        float e = s.vals[eRow];
+        gfx_PrintStringXY(e >= 1 ? "elastic" : (e <= 0 ? "sticks (e=0)" : "inelastic"), rightX, startY + rowH + 3);
+    }
+    gfx_PrintStringXY("y=: 1-D / 2-D", rightX, startY + 3 * rowH);
+    gfx_PrintStringXY("graph: simulate", rightX, startY + 4 * rowH);
+    gfx_PrintStringXY(",: EE (x10^)", rightX, startY + 5 * rowH);
+    gfx_PrintStringXY("del: clear cell", rightX, startY + 6 * rowH);
+    gfx_PrintStringXY("mode: reset", rightX, startY + 7 * rowH);
+    gfx_PrintStringXY("clear: quit", rightX, startY + 8 * rowH);
+
+    int eqY = startY + colRows[curSys] * rowH + 4;
+    printEqList(eqUsed, eqY);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(curRow, true, parseInput());
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, false, 0);
+    autoSolve();
+}
+
+// Both collision tables, which one is showing and its equations.
+const ModChunk stateChunks[] = {
+    {systems, sizeof(systems)},
+    {&curSys, sizeof(curSys)},
+    {eqUsed, sizeof(eqUsed)}
+};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(MOM_STATE_VAR);
+    if (!resume || !loadModState(MOM_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevEnter = false, prevClear = false, prevDel = false;
+    bool prevMode = false, prevGraph = false, prevYequ = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool yequ = kb_Data[1] & kb_Yequ;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (yequ && !prevYequ) {
+                curSys = (curSys + 1) % SYS_COUNT;
+                curRow = 0;
+                autoSolve();
+            }
+            if (graph && !prevGraph) runSim();
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        curRow = (curRow + move + colRows[curSys]) % colRows[curSys];
+
+        prevUp = up; prevDown = down; prevEnter = enter; prevClear = clear; prevDel = del;
+        prevMode = mode; prevGraph = graph; prevYequ = yequ; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(MOM_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
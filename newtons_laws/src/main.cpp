@@ -0,0 +1,616 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "linsolve.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define GRAVITY 9.81f
+#define PI 3.14159265f
+#define DEG_TO_RAD (PI / 180.0f)
+
+#define TPL_INCLINE 0
+#define TPL_ATWOOD 1
+#define TPL_PULLEY 2
+#define TPL_CHAIN 3
+#define TPL_COUNT 4
+
+#define MAX_PARAMS 8
+#define MAX_OUTS 4
+
+#define STATUS_NONE 0
+#define STATUS_REST 1
+#define STATUS_POS 2
+#define STATUS_NEG 3
+
+#define RAMP_STATIC 0
+#define RAMP_UP 1
+#define RAMP_DOWN 2
+#define RAMP_SEGMENTS 32
+#define RAMP_SCAN 48
+#define RAMP_ROOT_ITERS 24
+#define RAMP_COLS 280
+#define RAMP_COLS_PER_FRAME 4
+
+// Each configuration is a fixed list of inputs and the unknowns of its
+// linear system, in the order the solver returns them.
+struct ForceTemplate {
+    const char* title;
+    int paramCount, outCount;
+    const char* params[MAX_PARAMS];
+    const char* paramUnits[MAX_PARAMS];
+    float defaults[MAX_PARAMS];
+    uint8_t defaultMask;
+    const char* outs[MAX_OUTS];
+    const char* outUnits[MAX_OUTS];
+    const char* statusText[4];
+    const char* eqs[4];
+};
+
+const ForceTemplate templates[TPL_COUNT] = {
+    {"BLOCK ON INCLINE", 8, 3,
+     {"m", "th", "mus", "muk", "F", "g", "Fa", "wF"},
+     {"kg", "deg", "", "", "N", "m/s^2", "N", "rad/s"},
+     {0, 0, 0, 0, 0, GRAVITY, 0, 0}, 0xFE,
+     {"a", "N", "f"},
+     {"m/s^2", "N", "N"},
+     {"", "at rest", "slides up", "slides down"},
+     {"N = m*g*cos(th)", "m*a = F - m*g*sin(th) + f", "f = -muk*N (moving)", "graph: F(t) = F + Fa*sin(wF*t)"}},
+    {"ATWOOD MACHINE", 3, 2,
+     {"m1", "m2", "g"},
+     {"kg", "kg", "m/s^2"},
+     {0, 0, GRAVITY}, 0x04,
+     {"a", "T"},
+     {"m/s^2", "N"},
+     {"", "balanced", "m2 falls", "m1 falls"},
+     {"m1*a = T - m1*g", "m2*a = m2*g - T"}},
+    {"INCLINE + HANGING", 6, 4,
+     {"m1", "m2", "th", "mus", "muk", "g"},
+     {"kg", "kg", "deg", "", "", "m/s^2"},
+     {0, 0, 0, 0, 0, GRAVITY}, 0x3C,
+     {"a", "T", "N", "f"},
+     {"m/s^2", "N", "N", "N"},
+     {"", "at rest", "m2 falls", "m1 slides down"},
+     {"m1*a = T - m1*g*sin(th) + f", "m2*a = m2*g - T", "N = m1*g*cos(th)", "f = -muk*N (moving)"}},
+    {"3 BLOCKS PULLED", 7, 3,
+     {"m1", "m2", "m3", "F", "mus", "muk", "g"},
+     {"kg", "kg", "kg", "N", "", "", "m/s^2"},
+     {0, 0, 0, 0, 0, 0, GRAVITY}, 0x78,
+     {"a", "T12", "T23"},
+     {"m/s^2", "N", "N"},
+     {"", "at rest", "moves", "moves back"},
+     {"m1*a = F - T12 - muk*m1*g", "m2*a = T12 - T23 - muk*m2*g", "m3*a = T23 - muk*m3*g"}}
+};
+
+struct ForceState {
+    float params[MAX_PARAMS];
+    float outs[MAX_OUTS];
+    uint8_t known, outKnown;
+    uint8_t status;
+};
+
+ForceState states[TPL_COUNT];
+int curTpl = TPL_INCLINE;
+
+int curRow = 0;
+
+void initData() {
+    memset(states, 0, sizeof(states));
+    for (int t = 0; t < TPL_COUNT; t++) {
+        for (int i = 0; i < templates[t].paramCount; i++) states[t].params[i] = templates[t].defaults[i];
+        states[t].known = templates[t].defaultMask;
+    }
+}
+
+// x = (a, N, f), positive up the slope. The last row is the friction law:
+// with s = 0 the block is held still (a = 0, f free); otherwise
+// f = -s*muk*N against the motion s = +-1.
+void assembleIncline(const float* p, float s, float m[3][4]) {
+    float mass = p[0], th = p[1] * DEG_TO_RAD, muk = p[3], force = p[4], g = p[5];
+    float rows[3][4] = {
+        {0, 1, 0, mass * g * cosf(th)},
+        {mass, 0, -1, force - mass * g * sinf(th)},
+        {0, s * muk, 1, 0}
+    };
+    if (s == 0) {
+        rows[2][0] = 1;
+        rows[2][2] = 0;
+    }
+    memcpy(m, rows, sizeof(rows));
+}
+
+// x = (a, T, N, f), positive with m1 moving up the slope and m2 falling.
+void assemblePulley(const float* p, float s, float m[4][5]) {
+    float m1 = p[0], m2 = p[1], th = p[2] * DEG_TO_RAD, muk = p[4], g = p[5];
+    float rows[4][5] = {
+        {m1, -1, 0, -1, -m1 * g * sinf(th)},
+        {m2, 1, 0, 0, m2 * g},
+        {0, 0, 1, 0, m1 * g * cosf(th)},
+        {0, 0, s * muk, 1, 0}
+    };
+    if (s == 0) {
+        rows[3][0] = 1;
+        rows[3][3] = 0;
+    }
+    memcpy(m, rows, sizeof(rows));
+}
+
+// For the two templates with one friction unknown: hold the system still and
+// see whether static friction can supply the force that takes. If not, it
+// slides against the friction it needed, with kinetic friction.
+template <int N>
+uint8_t solveWithFriction(void (*assemble)(const float*, float, float[N][N + 1]), const float* p,
+                          float mus, int nRow, float x[N]) {
+    float m[N][N + 1];
+    assemble(p, 0, m);
+    if (!gaussSolve<N>(m, x)) return STATUS_NONE;
+    float need = x[N - 1], normal = x[nRow];
+    if (fabsf(need) <= mus * normal) return STATUS_REST;
+
+    float s = (need > 0) ? -1 : 1;
+    assemble(p, s, m);
+    if (!gaussSolve<N>(m, x)) return STATUS_NONE;
+    return (s > 0) ? STATUS_POS : STATUS_NEG;
+}
+
+uint8_t solveAtwood(const float* p, float x[2]) {
+    float m1 = p[0], m2 = p[1], g = p[2];
+    float m[2][3] = {
+        {m1, -1, -m1 * g},
+        {m2, 1, m2 * g}
+    };
+    if (!gaussSolve<2>(m, x)) return STATUS_NONE;
+    if (x[0] == 0) return STATUS_REST;
+    return (x[0] > 0) ? STATUS_POS : STATUS_NEG;
+}
+
+// x = (a, T12, T23). At rest the split of static friction between the blocks
+// is not determined, so only a is reported.
+uint8_t solveChain(const float* p, float x[3], uint8_t* outKnown) {
+    float m1 = p[0], m2 = p[1], m3 = p[2], force = p[3], mus = p[4], muk = p[5], g = p[6];
+    if (fabsf(force) <= mus * (m1 + m2 + m3) * g) {
+        x[0] = 0;
+        *outKnown = BIT(0);
+        return STATUS_REST;
+    }
+    float s = (force > 0) ? 1 : -1;
+    float m[3][4] = {
+        {m1, 1, 0, force - s * muk * m1 * g},
+        {m2, -1, 1, -s * muk * m2 * g},
+        {m3, 0, -1, -s * muk * m3 * g}
+    };
+    if (!gaussSolve<3>(m, x)) return STATUS_NONE;
+    return (s > 0) ? STATUS_POS : STATUS_NEG;
+}
+
+void autoSolve() {
+    ForceState& s = states[curTpl];
+    const ForceTemplate& t = templates[curTpl];
+    s.outKnown = 0;
+    s.status = STATUS_NONE;
+    uint8_t all = (1 << t.paramCount) - 1;
+    if ((s.known & all) != all) return;
+
+    const float* p = s.params;
+    uint8_t known = (1 << t.outCount) - 1;
+    if (curTpl == TPL_INCLINE) {
+        if (p[0] <= 0) return;
+        s.status = solveWithFriction<3>(assembleIncline, p, p[2], 1, s.outs);
+    } else if (curTpl == TPL_ATWOOD) {
+        if (p[0] + p[1] <= 0) return;
+        s.status = solveAtwood(p, s.outs);
+    } else if (curTpl == TPL_PULLEY) {
+        if (p[0] + p[1] <= 0) return;
+        s.status = solveWithFriction<4>(assemblePulley, p, p[3], 2, s.outs);
+    } else {
+        if (p[0] + p[1] + p[2] <= 0) return;
+        s.status = solveChain(p, s.outs, &known);
+    }
+    if (s.status != STATUS_NONE) s.outKnown = known;
+}
+
+void setCell(int row, bool set, float val) {
+    ForceState& s = states[curTpl];
+    s.params[row] = set ? val : 0;
+    if (set) s.known |= BIT(row);
+    else s.known &= ~BIT(row);
+}
+
+// The incline block under F(t) = F + Fa*sin(wF*t), starting at rest. Each
+// segment is one friction regime; inside it x and v are closed forms, and the
+// next regime starts at a root found by scanning for a sign change and then
+// bisecting.
+struct RampSeg {
+    float t0, x0, v0;
+    uint8_t regime;
+};
+
+struct RampSim {
+    float m, weight, normal, mus, muk;
+    float f0, f1, w;
+    float tEnd;
+    RampSeg seg[RAMP_SEGMENTS];
+    int count;
+};
+
+RampSim ramp;
+
+// Net push along the slope before friction.
+float rampDrive(const RampSim* r, float t) {
+    return r->f0 + r->f1 * sinf(r->w * t) - r->weight;
+}
+
+float rampDir(const RampSeg* g) {
+    return (g->regime == RAMP_UP) ? 1 : (g->regime == RAMP_DOWN ? -1 : 0);
+}
+
+// a(t) = c + b sin(w t) while sliding, integrated from the segment start.
+float rampVel(const RampSim* r, const RampSeg* g, float t) {
+    if (g->regime == RAMP_STATIC) return 0;
+    float c = (r->f0 - r->weight - rampDir(g) * r->muk * r->normal) / r->m;
+    float tau = t - g->t0;
+    float v = g->v0 + c * tau;
+    if (r->w > 0) v += r->f1 / (r->m * r->w) * (cosf(r->w * g->t0) - cosf(r->w * t));
+    return v;
+}
+
+float rampPos(const RampSim* r, const RampSeg* g, float t) {
+    if (g->regime == RAMP_STATIC) return g->x0;
+    float c = (r->f0 - r->weight - rampDir(g) * r->muk * r->normal) / r->m;
+    float tau = t - g->t0;
+    float x = g->x0 + g->v0 * tau + 0.5f * c * tau * tau;
+    if (r->w > 0) {
+        float k = r->f1 / (r->m * r->w);
+        x += k * cosf(r->w * g->t0) * tau - k / r->w * (sinf(r->w * t) - sinf(r->w * g->t0));
+    }
+    return x;
+}
+
+// Positive once the block should leave the segment's regime.
+float rampExit(const RampSim* r, const RampSeg* g, float t) {
+    if (g->regime == RAMP_STATIC) return fabsf(rampDrive(r, t)) - r->mus * r->normal;
+    return -rampDir(g) * rampVel(r, g, t);
+}
+
+float rampSwitch(const RampSim* r, const RampSeg* g) {
+    float h = r->tEnd / RAMP_SCAN;
+    if (r->w > 0 && 2 * PI / r->w / RAMP_SCAN < h) h = 2 * PI / r->w / RAMP_SCAN;
+    float lo = g->t0;
+    for (float t = g->t0 + h; lo < r->tEnd; t += h) {
+        if (t > r->tEnd) t = r->tEnd;
+        if (rampExit(r, g, t) > 0) {
+            float hi = t;
+            for (int i = 0; i < RAMP_ROOT_ITERS; i++) {
+                float mid = 0.5f * (lo + hi);
+                if (rampExit(r, g, mid) > 0) hi = mid;
+                else lo = mid;
+            }
+            return hi;
+        }
+        lo = t;
+    }
+    return r->tEnd;
+}
+
+uint8_t rampRegimeAt(const RampSim* r, float t) {
+    float d = rampDrive(r, t);
+    if (fabsf(d) <= r->mus * r->normal) return RAMP_STATIC;
+    return (d > 0) ? RAMP_UP : RAMP_DOWN;
+}
+
+bool buildRamp(RampSim* r) {
+    const ForceState& s = states[TPL_INCLINE];
+    if ((s.known & 0xFF) != 0xFF || s.params[0] <= 0) return false;
+    const float* p = s.params;
+    float th = p[1] * DEG_TO_RAD;
+    r->m = p[0];
+    r->weight = p[0] * p[5] * sinf(th);
+    r->normal = p[0] * p[5] * cosf(th);
+    r->mus = p[2];
+    r->muk = p[3];
+    r->f0 = p[4];
+    r->f1 = p[6];
+    r->w = (p[7] > 0) ? p[7] : 0;
+    r->tEnd = (r->w > 0) ? 3 * 2 * PI / r->w : 5;
+    if (r->tEnd > 30) r->tEnd = 30;
+
+    r->count = 1;
+    r->seg[0].t0 = 0;
+    r->seg[0].x0 = 0;
+    r->seg[0].v0 = 0;
+    r->seg[0].regime = rampRegimeAt(r, 0);
+    while (r->count < RAMP_SEGMENTS) {
+        RampSeg* g = &r->seg[r->count - 1];
+        float t = rampSwitch(r, g);
+        if (t >= r->tEnd) break;
+        RampSeg* n = &r->seg[r->count++];
+        n->t0 = t;
+        n->x0 = rampPos(r, g, t);
+        n->v0 = 0;
+        // Sticking ends when the drive beats static friction; sliding ends when
+        // v reaches 0, and then the block sticks or turns around.
+        n->regime = rampRegimeAt(r, t);
+        if (g->regime == RAMP_STATIC && n->regime == RAMP_STATIC) {
+            n->regime = (rampDrive(r, t) > 0) ? RAMP_UP : RAMP_DOWN;
+        }
+    }
+    return true;
+}
+
+struct RampPlot {
+    float xs[RAMP_COLS + 1], vs[RAMP_COLS + 1];
+    uint8_t xRow[RAMP_COLS + 1], vRow[RAMP_COLS + 1];
+    uint8_t regime[RAMP_COLS + 1];
+    float xMin, xMax, vMax;
+};
+
+RampPlot rampPlot;
+
+// Evaluates every column once; the animation then only reads the cache.
+void sampleRamp(const RampSim* r, RampPlot* c, int xTop, int xBottom, int vTop, int vBottom) {
+    float* xs = c->xs;
+    float* vs = c->vs;
+    float dt = r->tEnd / RAMP_COLS;
+    int k = 0;
+    c->xMin = c->xMax = c->vMax = 0;
+    for (int i = 0; i <= RAMP_COLS; i++) {
+        float t = i * dt;
+        while (k + 1 < r->count && r->seg[k + 1].t0 <= t) k++;
+        xs[i] = rampPos(r, &r->seg[k], t);
+        vs[i] = rampVel(r, &r->seg[k], t);
+        c->regime[i] = r->seg[k].regime;
+        if (xs[i] < c->xMin) c->xMin = xs[i];
+        if (xs[i] > c->xMax) c->xMax = xs[i];
+        if (fabsf(vs[i]) > c->vMax) c->vMax = fabsf(vs[i]);
+    }
+    float xRange = c->xMax - c->xMin;
+    if (xRange < 0.01f) xRange = 0.01f;
+    float vRange = (c->vMax < 0.01f) ? 0.01f : c->vMax;
+    int vMid = (vTop + vBottom) / 2;
+    for (int i = 0; i <= RAMP_COLS; i++) {
+        c->xRow[i] = (uint8_t)(xBottom - (int)((xs[i] - c->xMin) / xRange * (xBottom - xTop)));
+        c->vRow[i] = (uint8_t)(vMid - (int)(vs[i] / vRange * (vBottom - vMid)));
+    }
+}
+
+const char* rampNames[3] = {"sticking", "sliding up", "sliding down"};
+
+// Draws a few new columns per frame and leaves the old ones in the buffer, so
+// each frame costs the same however far along the plot is.
+void runRamp() {
+    RampSim* r = &ramp;
+    RampPlot* c = &rampPlot;
+    if (!buildRamp(r)) {
+        drawMessage("Need m and every input set");
+        return;
+    }
+    int graphX = 30, xTop = 26, xBottom = 110, vTop = 122, vBottom = 206;
+    sampleRamp(r, c, xTop, xBottom, vTop, vBottom);
+
+    char buf[15];
+    gfx_FillScreen(255);
+    gfx_SetColor(200);
+    gfx_Rectangle(graphX, xTop, RAMP_COLS + 1, xBottom - xTop + 1);
+    gfx_Rectangle(graphX, vTop, RAMP_COLS + 1, vBottom - vTop + 1);
+    gfx_HorizLine(graphX, (vTop + vBottom) / 2, RAMP_COLS);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("x", 14, xTop + 2);
+    gfx_PrintStringXY("v", 14, vTop + 2);
+    floatToStr(c->xMax, buf);
+    gfx_PrintStringXY(buf, graphX + 2, xTop + 2);
+    floatToStr(c->vMax, buf);
+    gfx_PrintStringXY(buf, graphX + 2, vTop + 2);
+    gfx_PrintStringXY("t:", 230, vBottom + 4);
+    floatToStr(r->tEnd, buf);
+    gfx_PrintStringXY(buf, 248, vBottom + 4);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("red: sticking  clear: return", 44, 228);
+
+    int col = 1;
+    bool running = true;
+    while (running) {
+        for (int n = 0; n < RAMP_COLS_PER_FRAME && col <= RAMP_COLS; n++, col++) {
+            gfx_SetColor(c->regime[col] == RAMP_STATIC ? 224 : 24);
+            gfx_Line(graphX + col - 1, c->xRow[col - 1], graphX + col, c->xRow[col]);
+            gfx_Line(graphX + col - 1, c->vRow[col - 1], graphX + col, c->vRow[col]);
+        }
+
+        int last = col - 1;
+        gfx_SetColor(255);
+        gfx_FillRectangle(0, 0, 320, 24);
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("t:", 2, 2);
+        floatToStr(last * r->tEnd / RAMP_COLS, buf);
+        gfx_PrintStringXY(buf, 20, 2);
+        gfx_PrintStringXY("F:", 110, 2);
+        floatToStr(rampDrive(r, last * r->tEnd / RAMP_COLS) + r->weight, buf);
+        gfx_PrintStringXY(buf, 128, 2);
+        gfx_SetTextFGColor(c->regime[last] == RAMP_STATIC ? 224 : 24);
+        gfx_PrintStringXY(rampNames[c->regime[last]], 210, 2);
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("regime changes:", 2, 13);
+        floatToStr((float)(r->count - 1), buf);
+        gfx_PrintStringXY(buf, 124, 13);
+        gfx_BlitBuffer();
+
+        kb_Scan();
+        if (kb_Data[6] & kb_Clear) running = false;
+    }
+    waitKeyRelease();
+}
+
+void drawRow(const char* label, const char* unit, bool selected, bool editing, bool known, bool input, float val, int y) {
+    int startX = 5, labelW = 40, boxW = 84, rowH = 15;
+    int x = startX + labelW;
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY(label, startX + 2, y + 3);
+    if (selected) {
+        gfx_SetColor(183);
+        gfx_FillRectangle(x, y, boxW, rowH - 2);
+    } else if (editing) {
+        gfx_SetColor(239);
+        gfx_FillRectangle(x, y, boxW, rowH - 2);
+    }
+    gfx_SetColor(input ? 0 : 148);
+    gfx_Rectangle(x, y, boxW, rowH - 2);
+
+    char buf[15];
+    if (editing) {
+        inputText(buf);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else if (known) {
+        floatToStr(val, buf);
+        gfx_SetTextFGColor(input ? 0 : 24);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else {
+        gfx_PrintStringXY("?", x + boxW / 2 - 4, y + 3);
+    }
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY(unit, x + boxW + 4, y + 3);
+}
+
+void drawTable() {
+    const ForceState& s = states[curTpl];
+    const ForceTemplate& t = templates[curTpl];
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("FORCES - Evan Kolberg", 84, 3);
+
+    int startY = 16;
+    int rowH = 15;
+    for (int row = 0; row < t.paramCount; row++) {
+        bool selected = (row == curRow && !inputMode);
+        bool editing = (row == curRow && inputMode);
+        drawRow(t.params[row], t.paramUnits[row], selected, editing, s.known & BIT(row), true, s.params[row], startY + row * rowH);
+    }
+    int outY = startY + t.paramCount * rowH + 4;
+    gfx_SetColor(0);
+    gfx_HorizLine(5, outY - 3, 170);
+    for (int i = 0; i < t.outCount; i++) {
+        drawRow(t.outs[i], t.outUnits[i], false, false, s.outKnown & BIT(i), false, s.outs[i], outY + i * rowH);
+    }
+
+    int rightX = 180;
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY(t.title, rightX, startY + 3);
+    if (s.status != STATUS_NONE) {
+        gfx_SetTextFGColor(224);
+        gfx_PrintStringXY(t.statusText[s.status], rightX, startY + rowH + 3);
+        gfx_SetTextFGColor(24);
+    }
+    gfx_PrintStringXY("y=: next setup", rightX, startY + 3 * rowH);
+    if (curTpl == TPL_INCLINE) gfx_PrintStringXY("graph: run F(t)", rightX, startY + 4 * rowH);
+    gfx_PrintStringXY(",: EE (x10^)", rightX, startY + 5 * rowH);
+    gfx_PrintStringXY("del: clear cell", rightX, startY + 6 * rowH);
+    gfx_PrintStringXY("mode: reset", rightX, startY + 7 * rowH);
+    gfx_PrintStringXY("clear: quit", rightX, startY + 8 * rowH);
+
+    int eqY = outY + t.outCount * rowH + 4;
+    for (int i = 0; i < 4 && t.eqs[i] && eqY < 230; i++) {
+        gfx_PrintStringXY(t.eqs[i], 5, eqY);
+        eqY += 10;
+    }
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(curRow, true, parseInput());
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, false, 0);
+    autoSolve();
+}
+
+// Every template's table and which one is showing.
+const ModChunk stateChunks[] = {{states, sizeof(states)}, {&curTpl, sizeof(curTpl)}};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(FORCE_STATE_VAR);
+    if (!resume || !loadModState(FORCE_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevEnter = false, prevClear = false, prevDel = false;
+    bool prevMode = false, prevGraph = false, prevYequ = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool yequ = kb_Data[1] & kb_Yequ;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (yequ && !prevYequ) {
+                curTpl = (curTpl + 1) % TPL_COUNT;
+                curRow = 0;
+                autoSolve();
+            }
+            if (graph && !prevGraph && curTpl == TPL_INCLINE) runRamp();
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        int rows = templates[curTpl].paramCount;
+        curRow = (curRow + move + rows) % rows;
+
+        prevUp = up; prevDown = down; prevEnter = enter; prevClear = clear; prevDel = del;
+        prevMode = mode; prevGraph = graph; prevYequ = yequ; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(FORCE_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
@@ -0,0 +1,735 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define G_CONST 6.674e-11f
+#define PI 3.14159265f
+#define EARTH_MASS 5.972e24f
+
+#define ORB_VARS 10
+#define OV_M 0
+#define OV_MSAT 1
+#define OV_R0 2
+#define OV_V0 3
+#define OV_A 4
+#define OV_E 5
+#define OV_T 6
+#define OV_EPS 7
+#define OV_VC 8
+#define OV_VESC 9
+
+#define FX_SHIFT 24
+#define FX_ONE (1L << FX_SHIFT)
+
+#define ORBIT_STEPS 360
+#define ORBIT_FRAMES 240
+#define ORBIT_MAX_R 100
+#define ORBIT_MIN_R 0.002f
+
+// Newton's inverse square root, in units where 2^29 is one. The cold seed is
+// the middle of w's range, close enough to converge from anywhere in it.
+#define INV_R_ONE ((uint32_t)1 << 29)
+#define INV_R_SEED 1276901417UL
+#define INV_R_TOL 64
+#define INV_R_MAX_ITERS 8
+#define INV_R_MIN_R2S ((uint32_t)1 << 28)
+
+#define KEPLER_SAMPLES 160
+#define KEPLER_MAX_ITERS 8
+#define KEPLER_TOL 1e-6f
+
+// Launch is from r0 at right angles to the radius, so r0 is always an apsis.
+struct OrbitState {
+    float vals[ORB_VARS];
+    uint16_t known, userSet;
+};
+
+OrbitState st;
+
+int curRow = 0;
+
+const char* orbLabels[ORB_VARS] = {"M", "m", "r0", "v0", "a", "e", "T", "E/m", "vc", "vesc"};
+const char* orbUnits[ORB_VARS] = {"kg", "kg", "m", "m/s", "m", "", "s", "J/kg", "m/s", "m/s"};
+
+char eqUsed[64] = "";
+
+void initData() {
+    memset(&st, 0, sizeof(st));
+    st.vals[OV_M] = EARTH_MASS;
+    st.known = st.userSet = BIT(OV_M) | BIT(OV_MSAT);
+}
+
+bool isKnown(const OrbitState& s, int i) {
+    return s.known & BIT(i);
+}
+
+void derive(OrbitState& s, int i, float val, const char* eq) {
+    s.vals[i] = val;
+    s.known |= BIT(i);
+    addEq(eqUsed, eq);
+}
+
+// GM of the pair, from the masses or from whichever pair of orbit values
+// pins it down.
+bool findMu(const OrbitState& s, float* mu) {
+    const float* v = s.vals;
+    if (isKnown(s, OV_M) && isKnown(s, OV_MSAT)) {
+        *mu = G_CONST * (v[OV_M] + v[OV_MSAT]);
+    } else if (isKnown(s, OV_A) && isKnown(s, OV_T) && v[OV_T] > 0) {
+        *mu = 4 * PI * PI * v[OV_A] * v[OV_A] * v[OV_A] / (v[OV_T] * v[OV_T]);
+    } else if (isKnown(s, OV_R0) && isKnown(s, OV_VC)) {
+        *mu = v[OV_VC] * v[OV_VC] * v[OV_R0];
+    } else if (isKnown(s, OV_R0) && isKnown(s, OV_VESC)) {
+        *mu = 0.5f * v[OV_VESC] * v[OV_VESC] * v[OV_R0];
+    } else if (isKnown(s, OV_A) && isKnown(s, OV_EPS)) {
+        *mu = -2 * v[OV_A] * v[OV_EPS];
+    } else {
+        return false;
+    }
+    return *mu > 0;
+}
+
+void autoSolve() {
+    OrbitState& s = st;
+    float* v = s.vals;
+    eqUsed[0] = '\0';
+    s.known &= s.userSet;
+
+    for (int iter = 0; iter < 4; iter++) {
+        if (!isKnown(s, OV_E) && isKnown(s, OV_R0) && isKnown(s, OV_A) && v[OV_A] != 0) {
+            derive(s, OV_E, fabsf(1 - v[OV_R0] / v[OV_A]), "e = |1 - r0/a|");
+        }
+
+        float mu;
+        if (!findMu(s, &mu)) continue;
+        if (!isKnown(s, OV_M) && isKnown(s, OV_MSAT)) {
+            derive(s, OV_M, mu / G_CONST - v[OV_MSAT], "M = GM/G - m");
+        }
+
+        if (!isKnown(s, OV_EPS) && isKnown(s, OV_R0) && isKnown(s, OV_V0) && v[OV_R0] > 0) {
+            derive(s, OV_EPS, 0.5f * v[OV_V0] * v[OV_V0] - mu / v[OV_R0], "E/m = v0^2/2 - GM/r0");
+        }
+        if (!isKnown(s, OV_EPS) && isKnown(s, OV_A) && v[OV_A] != 0) {
+            derive(s, OV_EPS, -mu / (2 * v[OV_A]), "E/m = -GM / 2a");
+        }
+        if (!isKnown(s, OV_A) && isKnown(s, OV_EPS) && v[OV_EPS] != 0) {
+            derive(s, OV_A, -mu / (2 * v[OV_EPS]), "a = -GM / 2(E/m)");
+        }
+        if (!isKnown(s, OV_A) && isKnown(s, OV_T) && v[OV_T] > 0) {
+            derive(s, OV_A, cbrtf(mu * v[OV_T] * v[OV_T] / (4 * PI * PI)), "a^3 = GM*T^2 / 4pi^2");
+        }
+        if (!isKnown(s, OV_T) && isKnown(s, OV_A) && v[OV_A] > 0) {
+            derive(s, OV_T, 2 * PI * sqrtf(v[OV_A] * v[OV_A] * v[OV_A] / mu), "T = 2pi*sqrt(a^3/GM)");
+        }
+        if (!isKnown(s, OV_R0) && isKnown(s, OV_VC) && v[OV_VC] > 0) {
+            derive(s, OV_R0, mu / (v[OV_VC] * v[OV_VC]), "r0 = GM / vc^2");
+        }
+        if (!isKnown(s, OV_R0) && isKnown(s, OV_VESC) && v[OV_VESC] > 0) {
+            derive(s, OV_R0, 2 * mu / (v[OV_VESC] * v[OV_VESC]), "r0 = 2GM / vesc^2");
+        }
+        if (!isKnown(s, OV_R0) && isKnown(s, OV_V0) && isKnown(s, OV_EPS)) {
+            float den = 0.5f * v[OV_V0] * v[OV_V0] - v[OV_EPS];
+            if (den > 0) derive(s, OV_R0, mu / den, "r0 = GM / (v0^2/2 - E/m)");
+        }
+        if (!isKnown(s, OV_V0) && isKnown(s, OV_R0) && isKnown(s, OV_EPS) && v[OV_R0] > 0) {
+            float v2 = 2 * (v[OV_EPS] + mu / v[OV_R0]);
+            if (v2 >= 0) derive(s, OV_V0, sqrtf(v2), "v0^2 = 2(E/m + GM/r0)");
+        }
+        if (isKnown(s, OV_R0) && v[OV_R0] > 0) {
+            if (!isKnown(s, OV_VC)) derive(s, OV_VC, sqrtf(mu / v[OV_R0]), "vc = sqrt(GM/r0)");
+            if (!isKnown(s, OV_VESC)) derive(s, OV_VESC, sqrtf(2 * mu / v[OV_R0]), "vesc = sqrt(2GM/r0)");
+        }
+        if (!isKnown(s, OV_E) && isKnown(s, OV_R0) && isKnown(s, OV_V0) && v[OV_R0] > 0) {
+            derive(s, OV_E, fabsf(v[OV_R0] * v[OV_V0] * v[OV_V0] / mu - 1), "e = |r0*v0^2/GM - 1|");
+        }
+    }
+}
+
+void setCell(int row, bool set, float val) {
+    st.vals[row] = set ? val : 0;
+    if (set) {
+        st.known |= BIT(row);
+        st.userSet |= BIT(row);
+    } else {
+        st.known &= ~BIT(row);
+        st.userSet &= ~BIT(row);
+    }
+}
+
+// Positions and velocities in units of r0 and sqrt(GM/r0), so GM = 1 and the
+// start is (1, 0). They are Q24 fixed point, which holds |r| < 128. The
+// acceleration spans too wide a range for one fixed format, so it is kept
+// as a mantissa: the Q24 kick a*dt is ax*dt >> accShift. invR is the last
+// 1/r, the next step's Newton seed, and invShift the scale it was found at.
+struct OrbitSim {
+    int32_t x, y, vx, vy, ax, ay;
+    int32_t dt;
+    uint8_t accShift;
+    uint32_t invR;
+    uint8_t invShift;
+};
+
+// a*b >> shift, rounded, for shift < 64. The 64-bit product is built from
+// 16-bit halves so only 32-bit multiplies are needed; a result too big for 31
+// bits saturates. The kick passes shifts up to 40 far from the center.
+uint32_t mulShift(uint32_t a, uint32_t b, uint8_t shift) {
+    uint32_t al = a & 0xFFFF, ah = a >> 16, bl = b & 0xFFFF, bh = b >> 16;
+    uint32_t ll = al * bl, lh = al * bh, hl = ah * bl;
+    uint32_t mid = (ll >> 16) + (lh & 0xFFFF) + (hl & 0xFFFF);
+    uint32_t lo = (mid << 16) | (ll & 0xFFFF);
+    uint32_t hi = ah * bh + (lh >> 16) + (hl >> 16) + (mid >> 16);
+    if (shift == 0) return (hi || (lo >> 31)) ? 0x7FFFFFFF : lo;
+    if (shift > 32) {
+        // Only the high word is left; lo just decides the rounding.
+        uint8_t hs = shift - 32;
+        uint32_t q = hi >> hs, rem = hi - (q << hs);
+        uint32_t halfHs = (uint32_t)1 << (hs - 1);
+        return ((rem > halfHs || (rem == halfHs && lo)) && q < 0x7FFFFFFF) ? q + 1 : q;
+    }
+    uint32_t half = (uint32_t)1 << (shift - 1);
+    if (lo + half < lo) hi++;
+    lo += half;
+    if (hi >> (shift - 1)) return 0x7FFFFFFF;
+    if (shift == 32) return hi;
+    return (hi << (32 - shift)) | (lo >> shift);
+}
+
+int32_t fxMulShift(int32_t a, int32_t b, uint8_t shift) {
+    uint32_t r = mulShift(a < 0 ? -(uint32_t)a : a, b < 0 ? -(uint32_t)b : b, shift);
+    return ((a < 0) != (b < 0)) ? -(int32_t)r : (int32_t)r;
+}
+
+int32_t fxMul(int32_t a, int32_t b) {
+    return fxMulShift(a, b, FX_SHIFT);
+}
+
+// a = -r / |r|^3 without a square root or a divide. The position is scaled
+// by 2^-sh so r2s = |r|^2 lands in [2^28, 2^31), and w = 2^45 / sqrt(r2s) is
+// found by Newton's step for the inverse square root, w' = w(3 - r2s w^2)/2.
+// Seeded with the previous step's w it settles in one or two passes.
+void orbitAccel(OrbitSim* s) {
+    uint32_t ux = s->x < 0 ? -(uint32_t)s->x : s->x;
+    uint32_t uy = s->y < 0 ? -(uint32_t)s->y : s->y;
+    uint32_t m = ux > uy ? ux : uy;
+    uint8_t sh = s->invShift;
+    while (sh > 0 && (m >> (sh - 1)) < 0x8000) sh--;
+    while ((m >> sh) >= 0x8000) sh++;
+    uint32_t r2s = mulShift(ux, ux, 2 * sh) + mulShift(uy, uy, 2 * sh);
+    // Only possible with sh = 0, below r = 2^-10, where the pull is capped.
+    if (r2s < INV_R_MIN_R2S) r2s = INV_R_MIN_R2S;
+
+    uint32_t w = s->invR;
+    if (w == 0) w = INV_R_SEED;
+    else if (sh > s->invShift) w <<= sh - s->invShift;
+    else w >>= s->invShift - sh;
+    for (int i = 0; i < INV_R_MAX_ITERS; i++) {
+        uint32_t h = mulShift(r2s, mulShift(w, w, 32), 29);
+        if (h >= 3 * INV_R_ONE) {
+            w >>= 1;
+            continue;
+        }
+        uint32_t err = h > INV_R_ONE ? h - INV_R_ONE : INV_R_ONE - h;
+        if (err <= INV_R_TOL) break;
+        w = mulShift(w, 3 * INV_R_ONE - h, 30);
+    }
+    s->invR = w;
+    s->invShift = sh;
+
+    // In Q24, a = x w^3 / 2^(3sh) with w^3 carried as w^3 / 2^63. Dropping
+    // sh + 16 bits here still leaves over 23 in the larger component; the
+    // kick drops the rest.
+    uint32_t w3 = mulShift(mulShift(w, w, 32), w, 31);
+    uint32_t ax = mulShift(ux, w3, sh + 16);
+    uint32_t ay = mulShift(uy, w3, sh + 16);
+    s->accShift = 2 * sh + 8;
+    s->ax = s->x < 0 ? (int32_t)ax : -(int32_t)ax;
+    s->ay = s->y < 0 ? (int32_t)ay : -(int32_t)ay;
+}
+
+// Kick-drift-kick leapfrog, the velocity-Verlet form.
+void orbitStep(OrbitSim* s) {
+    int32_t half = s->dt / 2;
+    s->vx += fxMulShift(s->ax, half, s->accShift);
+    s->vy += fxMulShift(s->ay, half, s->accShift);
+    s->x += fxMul(s->vx, s->dt);
+    s->y += fxMul(s->vy, s->dt);
+    orbitAccel(s);
+    s->vx += fxMulShift(s->ax, half, s->accShift);
+    s->vy += fxMulShift(s->ay, half, s->accShift);
+}
+
+float orbitEnergy(const OrbitSim* s) {
+    float x = (float)s->x / FX_ONE, y = (float)s->y / FX_ONE;
+    float vx = (float)s->vx / FX_ONE, vy = (float)s->vy / FX_ONE;
+    return 0.5f * (vx * vx + vy * vy) - 1 / sqrtf(x * x + y * y);
+}
+
+struct OrbitView {
+    int cx, cy;
+    int32_t scale;
+};
+
+int viewX(const OrbitView* w, int32_t x) {
+    return w->cx + (int)fxMulShift(x, w->scale, FX_SHIFT + 8);
+}
+
+int viewY(const OrbitView* w, int32_t y) {
+    return w->cy - (int)fxMulShift(y, w->scale, FX_SHIFT + 8);
+}
+
+void drawOrbitInfo(float t, float r, float drift) {
+    char buf[15];
+    gfx_SetColor(255);
+    gfx_FillRectangle(0, 0, 320, 12);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("t:", 2, 2);
+    floatToStr(t, buf);
+    gfx_PrintStringXY(buf, 20, 2);
+    gfx_PrintStringXY("r:", 100, 2);
+    floatToStr(r, buf);
+    gfx_PrintStringXY(buf, 118, 2);
+    gfx_PrintStringXY("dE/E:", 200, 2);
+    floatToStr(drift, buf, 2);
+    gfx_PrintStringXY(buf, 244, 2);
+}
+
+// Animates the relative orbit, or both bodies about their barycenter when m is
+// set. The trail stays in the buffer; the bodies are drawn on the screen after
+// each blit so the next blit erases them.
+void runOrbit() {
+    float mu;
+    if (!findMu(st, &mu) || !isKnown(st, OV_R0) || !isKnown(st, OV_V0) || st.vals[OV_R0] <= 0) {
+        drawMessage("Need GM (M, m), r0 and v0");
+        return;
+    }
+    float r0 = st.vals[OV_R0];
+    float vc = sqrtf(mu / r0);
+    float v = st.vals[OV_V0] / vc;
+    float timeUnit = r0 / vc;
+    bool bound = v * v < 2;
+    float a = bound ? 1 / (2 - v * v) : 0;
+    float e = fabsf(v * v - 1);
+    float rp = (bound && v < 1) ? a * (1 - e) : 1;
+    if (rp < 0.01f) rp = 0.01f;
+
+    float xMin = -3, xMax = 3, yMax = 3;
+    if (bound) {
+        xMin = 1 - 2 * a;
+        xMax = 1;
+        yMax = a * sqrtf(1 - e * e);
+    }
+    float share = 1;
+    if (isKnown(st, OV_M) && isKnown(st, OV_MSAT) && st.vals[OV_MSAT] > 0) {
+        share = st.vals[OV_M] / (st.vals[OV_M] + st.vals[OV_MSAT]);
+        float xAbs = (-xMin > xMax) ? -xMin : xMax;
+        xMin = -xAbs;
+        xMax = xAbs;
+    }
+
+    OrbitView view;
+    int graphTop = 14;
+    float pixPerUnit = 300 / (xMax - xMin);
+    if (210 / (2 * yMax) < pixPerUnit) pixPerUnit = 210 / (2 * yMax);
+    pixPerUnit *= 0.9f;
+    view.scale = (int32_t)(pixPerUnit * 256);
+    view.cx = 160 - (int)(0.5f * (xMin + xMax) * pixPerUnit);
+    view.cy = graphTop + 105;
+
+    OrbitSim sim;
+    sim.x = FX_ONE;
+    sim.y = 0;
+    sim.vx = 0;
+    sim.vy = (int32_t)(v * FX_ONE);
+    sim.dt = (int32_t)(2 * PI * rp * sqrtf(rp) / ORBIT_STEPS * FX_ONE);
+    if (sim.dt < 1) sim.dt = 1;
+    sim.invR = 0;
+    sim.invShift = 0;
+    orbitAccel(&sim);
+
+    int stepsPerFrame = 2;
+    if (bound) {
+        stepsPerFrame = (int)(2 * PI * a * sqrtf(a) * FX_ONE / sim.dt / ORBIT_FRAMES);
+        if (stepsPerFrame < 1) stepsPerFrame = 1;
+    }
+    int32_t sharePart = (int32_t)(share * FX_ONE);
+    int32_t otherPart = FX_ONE - sharePart;
+    float e0 = orbitEnergy(&sim);
+
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("clear: return", 115, 228);
+    gfx_SetColor(0);
+    if (sharePart == FX_ONE) gfx_FillCircle(view.cx, view.cy, 3);
+
+    float t = 0;
+    bool running = true;
+    while (running) {
+        for (int i = 0; i < stepsPerFrame; i++) {
+            orbitStep(&sim);
+            gfx_SetColor(24);
+            gfx_SetPixel(viewX(&view, fxMul(sim.x, sharePart)), viewY(&view, fxMul(sim.y, sharePart)));
+            if (sharePart != FX_ONE) {
+                gfx_SetColor(224);
+                gfx_SetPixel(viewX(&view, -fxMul(sim.x, otherPart)), viewY(&view, -fxMul(sim.y, otherPart)));
+            }
+        }
+        t += stepsPerFrame * ((float)sim.dt / FX_ONE);
+
+        float x = (float)sim.x / FX_ONE, y = (float)sim.y / FX_ONE;
+        float r = sqrtf(x * x + y * y);
+        drawOrbitInfo(t * timeUnit, r * r0, (orbitEnergy(&sim) - e0) / fabsf(e0));
+        gfx_BlitBuffer();
+
+        gfx_SetDrawScreen();
+        gfx_SetColor(0);
+        gfx_FillCircle(viewX(&view, fxMul(sim.x, sharePart)), viewY(&view, fxMul(sim.y, sharePart)), 2);
+        if (sharePart != FX_ONE) gfx_FillCircle(viewX(&view, -fxMul(sim.x, otherPart)), viewY(&view, -fxMul(sim.y, otherPart)), 3);
+        gfx_SetDrawBuffer();
+
+        kb_Scan();
+        if (kb_Data[6] & kb_Clear) running = false;
+        if (r > ORBIT_MAX_R || r < ORBIT_MIN_R) {
+            while (!kb_AnyKey()) kb_Scan();
+            running = false;
+        }
+    }
+    waitKeyRelease();
+}
+
+// Halley's method on f(E) = E - e sin E - M. With a guess from the previous
+// sample it usually stops after one or two passes.
+float keplerIterate(float M, float e, float E) {
+    for (int i = 0; i < KEPLER_MAX_ITERS; i++) {
+        float es = e * sinf(E), ec = e * cosf(E);
+        float f = E - es - M;
+        float f1 = 1 - ec;
+        float d = f / f1;
+        d = f / (f1 - 0.5f * d * es);
+        E -= d;
+        if (fabsf(d) < KEPLER_TOL) break;
+    }
+    return E;
+}
+
+// Cold start from Danby's guess E = M + 0.85e, pushed towards apoapsis, which
+// stays on the right side of the root even for e close to 1. The root is
+// found for M reduced to [-pi, pi] and shifted back by the same turns.
+float keplerE(float M, float e) {
+    float m = fmodf(M, 2 * PI);
+    if (m > PI) m -= 2 * PI;
+    if (m < -PI) m += 2 * PI;
+    return keplerIterate(m, e, m + (sinf(m) < 0 ? -0.85f : 0.85f) * e) + (M - m);
+}
+
+// One period sampled at equal times from launch, in units of r0 with GM = 1.
+// Launch is at periapsis when v0 >= vc, otherwise at apoapsis.
+struct KeplerOrbit {
+    float a, e, period;
+    float m0;
+    bool fromApo;
+    float anomaly[KEPLER_SAMPLES + 1];
+    uint8_t rowX[KEPLER_SAMPLES + 1], rowY[KEPLER_SAMPLES + 1], rowR[KEPLER_SAMPLES + 1];
+};
+
+KeplerOrbit kep;
+
+void keplerPos(const KeplerOrbit* k, float E, float* x, float* y, float* r) {
+    float b = k->a * sqrtf(1 - k->e * k->e);
+    float c = cosf(E);
+    *x = k->a * (c - k->e);
+    *y = b * sinf(E);
+    *r = k->a * (1 - k->e * c);
+    if (k->fromApo) {
+        *x = -*x;
+        *y = -*y;
+    }
+}
+
+void keplerSample(KeplerOrbit* k, int mid, int half) {
+    float rMax = k->a * (1 + k->e);
+    float px = half / rMax;
+    float dM = 2 * PI / KEPLER_SAMPLES;
+    float E = keplerE(k->m0, k->e);
+    for (int i = 0; i <= KEPLER_SAMPLES; i++) {
+        float M = k->m0 + i * dM;
+        if (i > 0) {
+            // First-order step from the last root; near periapsis of a very
+            // thin ellipse it overshoots, so start cold there instead.
+            float step = dM / (1 - k->e * cosf(E));
+            E = (step < 0.5f) ? keplerIterate(M, k->e, E + step) : keplerE(M, k->e);
+        }
+        k->anomaly[i] = E;
+        float x, y, r;
+        keplerPos(k, E, &x, &y, &r);
+        k->rowX[i] = (uint8_t)(mid - (int)(x * px));
+        k->rowY[i] = (uint8_t)(mid - (int)(y * px));
+        k->rowR[i] = (uint8_t)(mid - (int)(r * px));
+    }
+}
+
+void drawKeplerInfo(int i, float r0, float timeUnit) {
+    const KeplerOrbit* k = &kep;
+    float x, y, r;
+    keplerPos(k, k->anomaly[i], &x, &y, &r);
+    float E = k->anomaly[i];
+    float nu = atan2f(sqrtf(1 - k->e * k->e) * sinf(E), cosf(E) - k->e) * (180 / PI);
+    if (nu < 0) nu += 360;
+
+    char buf[15];
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("t:", 2, 2);
+    floatToStr(i * k->period / KEPLER_SAMPLES * timeUnit, buf);
+    gfx_PrintStringXY(buf, 20, 2);
+    gfx_PrintStringXY("r:", 110, 2);
+    floatToStr(r * r0, buf);
+    gfx_PrintStringXY(buf, 128, 2);
+    gfx_PrintStringXY("nu:", 218, 2);
+    floatToStr(nu, buf);
+    gfx_PrintStringXY(buf, 244, 2);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("x:", 2, 13);
+    floatToStr(x * r0, buf);
+    gfx_PrintStringXY(buf, 20, 13);
+    gfx_SetTextFGColor(224);
+    gfx_PrintStringXY("y:", 110, 13);
+    floatToStr(y * r0, buf);
+    gfx_PrintStringXY(buf, 128, 13);
+}
+
+// x, y and r over one period from Kepler's equation, with a trace cursor.
+// The curves are sampled once; moving the cursor only redraws from the cache.
+void runKepler() {
+    float mu;
+    if (!findMu(st, &mu) || !isKnown(st, OV_R0) || !isKnown(st, OV_V0) || st.vals[OV_R0] <= 0) {
+        drawMessage("Need GM (M, m), r0 and v0");
+        return;
+    }
+    float r0 = st.vals[OV_R0];
+    float vc = sqrtf(mu / r0);
+    float v = st.vals[OV_V0] / vc;
+    if (v * v >= 2 || v == 0) {
+        drawMessage("Orbit is not an ellipse");
+        return;
+    }
+    KeplerOrbit* k = &kep;
+    k->a = 1 / (2 - v * v);
+    k->e = fabsf(v * v - 1);
+    k->period = 2 * PI * k->a * sqrtf(k->a);
+    k->fromApo = v < 1;
+    k->m0 = k->fromApo ? PI : 0;
+
+    int graphX = 30, graphW = 280;
+    int graphTop = 26, half = 90;
+    int mid = graphTop + half;
+    keplerSample(k, mid, half);
+
+    float timeUnit = r0 / vc;
+    char buf[15];
+    int cursor = 0;
+    bool running = true;
+    while (running) {
+        gfx_FillScreen(255);
+        gfx_SetColor(200);
+        gfx_Rectangle(graphX, graphTop, graphW, 2 * half + 1);
+        gfx_HorizLine(graphX, mid, graphW);
+
+        for (int i = 1; i <= KEPLER_SAMPLES; i++) {
+            int x0 = graphX + (i - 1) * graphW / KEPLER_SAMPLES;
+            int x1 = graphX + i * graphW / KEPLER_SAMPLES;
+            gfx_SetColor(24);
+            gfx_Line(x0, k->rowX[i - 1], x1, k->rowX[i]);
+            gfx_SetColor(224);
+            gfx_Line(x0, k->rowY[i - 1], x1, k->rowY[i]);
+            gfx_SetColor(0);
+            gfx_Line(x0, k->rowR[i - 1], x1, k->rowR[i]);
+        }
+
+        int cx = graphX + cursor * graphW / KEPLER_SAMPLES;
+        gfx_SetColor(148);
+        gfx_VertLine(cx, graphTop, 2 * half + 1);
+        gfx_SetColor(24);
+        gfx_FillCircle(cx, k->rowX[cursor], 2);
+        gfx_SetColor(224);
+        gfx_FillCircle(cx, k->rowY[cursor], 2);
+        gfx_SetColor(0);
+        gfx_FillCircle(cx, k->rowR[cursor], 2);
+
+        drawKeplerInfo(cursor, r0, timeUnit);
+        gfx_SetTextFGColor(0);
+        floatToStr(k->a * (1 + k->e) * r0, buf);
+        gfx_PrintStringXY(buf, graphX + 2, graphTop + 2);
+        gfx_PrintStringXY("T:", 230, graphTop + 2 * half + 5);
+        floatToStr(k->period * timeUnit, buf);
+        gfx_PrintStringXY(buf, 248, graphTop + 2 * half + 5);
+        gfx_PrintStringXY("r", graphX - 10, k->rowR[0] - 3);
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("left/right: trace  clear: return", 28, 228);
+        gfx_BlitBuffer();
+
+        kb_Scan();
+        if (kb_Data[7] & kb_Left) cursor = (cursor > 0) ? cursor - 1 : KEPLER_SAMPLES;
+        if (kb_Data[7] & kb_Right) cursor = (cursor < KEPLER_SAMPLES) ? cursor + 1 : 0;
+        if (kb_Data[6] & kb_Clear) running = false;
+    }
+    waitKeyRelease();
+}
+
+void drawTable() {
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("ORBITS - Evan Kolberg", 84, 3);
+
+    int startX = 5;
+    int startY = 16;
+    int rowH = 15;
+    int labelW = 40;
+    int boxW = 84;
+
+    for (int row = 0; row < ORB_VARS; row++) {
+        int y = startY + row * rowH;
+        bool selected = (row == curRow && !inputMode);
+        bool editing = (row == curRow && inputMode);
+        int x = startX + labelW;
+
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(orbLabels[row], startX + 2, y + 3);
+
+        if (selected) {
+            gfx_SetColor(183);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        } else if (editing) {
+            gfx_SetColor(239);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        }
+        gfx_SetColor(0);
+        gfx_Rectangle(x, y, boxW, rowH - 2);
+
+        char buf[15];
+        if (editing) {
+            inputText(buf);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else if (isKnown(st, row)) {
+            floatToStr(st.vals[row], buf);
+            gfx_SetTextFGColor((st.userSet & BIT(row)) ? 0 : 24);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else {
+            gfx_PrintStringXY("?", x + boxW / 2 - 4, y + 3);
+        }
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(orbUnits[row], x + boxW + 4, y + 3);
+    }
+
+    int rightX = 196;
+    gfx_SetTextFGColor(24);
+    if (isKnown(st, OV_EPS)) {
+        gfx_PrintStringXY(st.vals[OV_EPS] < 0 ? "bound orbit" : "escapes", rightX, startY + 3);
+    }
+    gfx_PrintStringXY("graph: animate", rightX, startY + 3 * rowH);
+    gfx_PrintStringXY("trace: r vs t", rightX, startY + 4 * rowH);
+    gfx_PrintStringXY(",: EE (x10^)", rightX, startY + 5 * rowH);
+    gfx_PrintStringXY("del: clear cell", rightX, startY + 6 * rowH);
+    gfx_PrintStringXY("mode: reset", rightX, startY + 7 * rowH);
+    gfx_PrintStringXY("clear: quit", rightX, startY + 8 * rowH);
+
+    int eqY = startY + ORB_VARS * rowH + 4;
+    printEqList(eqUsed, eqY);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(curRow, true, parseInput());
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, false, 0);
+    autoSolve();
+}
+
+// The orbit table and its equations.
+const ModChunk stateChunks[] = {{&st, sizeof(st)}, {eqUsed, sizeof(eqUsed)}};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(ORBIT_STATE_VAR);
+    if (!resume || !loadModState(ORBIT_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevEnter = false, prevClear = false, prevDel = false;
+    bool prevMode = false, prevGraph = false, prevTrace = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool trace = kb_Data[1] & kb_Trace;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (graph && !prevGraph) runOrbit();
+            if (trace && !prevTrace) runKepler();
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        curRow = (curRow + move + ORB_VARS) % ORB_VARS;
+
+        prevUp = up; prevDown = down; prevEnter = enter; prevClear = clear; prevDel = del;
+        prevMode = mode; prevGraph = graph; prevTrace = trace; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(ORBIT_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
@@ -0,0 +1,786 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define GRAVITY 9.81f
+#define PI 3.14159265f
+#define DEG_TO_RAD (PI / 180.0f)
+#define RAD_TO_DEG (180.0f / PI)
+
+#define SYS_SPRING 0
+#define SYS_PENDULUM 1
+#define SYS_DAMPED 2
+#define SYS_COUNT OSC_SYSTEMS
+
+#define PD_L 0
+#define PD_G 1
+#define PD_TH0 2
+#define PD_W0 3
+#define PD_T0 4
+#define PD_T 5
+#define PD_WMAX 6
+#define PD_VMAX 7
+#define PD_RATIO 8
+
+#define DM_M 0
+#define DM_K 1
+#define DM_B 2
+#define DM_W0 3
+#define DM_ZETA 4
+#define DM_WD 5
+#define DM_X0 6
+#define DM_V0 7
+#define DM_F0 8
+#define DM_WDR 9
+#define DM_A 10
+#define DM_DELTA 11
+
+#define REGIME_UNDER 0
+#define REGIME_CRITICAL 1
+#define REGIME_OVER 2
+#define CRITICAL_BAND 1e-3f
+
+#define SWEEP_COLS 280
+#define SWEEP_SPAN 3
+
+#define AGM_MAX_ITERS 8
+#define AGM_TOL 1e-6f
+#define AMP_BISECT_ITERS 24
+
+#define PHASE_SAMPLES 120
+
+OscState systems[SYS_COUNT];
+int curSys = SYS_SPRING;
+
+int curRow = 0;
+
+const char* oscTitles[SYS_COUNT] = {"SPRING-MASS", "PENDULUM", "DAMPED/DRIVEN"};
+const int oscRows[SYS_COUNT] = {9, 9, 12};
+const char* oscLabels[SYS_COUNT][OSC_MAX_VARS] = {
+    {"m", "k", "w", "f", "T", "A", "vmax", "amax", "E"},
+    {"L", "g", "th0", "w0", "T0", "T", "wmax", "vmax", "T/T0"},
+    {"m", "k", "b", "w0", "zeta", "wd", "x0", "v0", "F0", "wdr", "A", "delta"}
+};
+const char* oscUnits[SYS_COUNT][OSC_MAX_VARS] = {
+    {"kg", "N/m", "rad/s", "Hz", "s", "m", "m/s", "m/s^2", "J"},
+    {"m", "m/s^2", "deg", "rad/s", "s", "s", "rad/s", "m/s", ""},
+    {"kg", "N/m", "kg/s", "rad/s", "", "rad/s", "m", "m/s", "N", "rad/s", "m", "deg"}
+};
+
+char eqUsed[64] = "";
+
+void initData() {
+    memset(systems, 0, sizeof(systems));
+    OscState& p = systems[SYS_PENDULUM];
+    p.vals[PD_G] = GRAVITY;
+    p.known = p.userSet = BIT(PD_G);
+}
+
+bool isKnown(const OscState& s, int i) {
+    return s.known & BIT(i);
+}
+
+void derive(OscState& s, int i, float val, const char* eq) {
+    s.vals[i] = val;
+    s.known |= BIT(i);
+    addEq(eqUsed, eq);
+}
+
+// Arithmetic-geometric mean. The gap squares each pass, so even a 179 degree
+// swing (b near 0.01) is done in about six.
+float agm(float a, float b) {
+    for (int i = 0; i < AGM_MAX_ITERS && fabsf(a - b) > AGM_TOL * a; i++) {
+        float m = 0.5f * (a + b);
+        b = sqrtf(a * b);
+        a = m;
+    }
+    return 0.5f * (a + b);
+}
+
+// T/T0 = 1 / AGM(1, cos(th0/2)), the complete elliptic integral in closed form.
+float periodRatio(float th0) {
+    return 1 / agm(1, cosf(0.5f * th0));
+}
+
+// The ratio grows with amplitude, so bisect for the swing that gives it.
+float amplitudeForRatio(float ratio) {
+    float lo = 0, hi = PI;
+    for (int i = 0; i < AMP_BISECT_ITERS; i++) {
+        float mid = 0.5f * (lo + hi);
+        if (periodRatio(mid) < ratio) lo = mid;
+        else hi = mid;
+    }
+    return 0.5f * (lo + hi);
+}
+
+void solveSpring(OscState& s) {
+    float* v = s.vals;
+    for (int iter = 0; iter < 4; iter++) {
+        if (!isKnown(s, SP_W) && isKnown(s, SP_K) && isKnown(s, SP_M) && v[SP_M] > 0 && v[SP_K] >= 0) {
+            derive(s, SP_W, sqrtf(v[SP_K] / v[SP_M]), "w = sqrt(k/m)");
+        }
+        if (!isKnown(s, SP_W) && isKnown(s, SP_F)) {
+            derive(s, SP_W, 2 * PI * v[SP_F], "w = 2pi*f");
+        }
+        if (!isKnown(s, SP_W) && isKnown(s, SP_T) && v[SP_T] > 0) {
+            derive(s, SP_W, 2 * PI / v[SP_T], "w = 2pi/T");
+        }
+        if (!isKnown(s, SP_W) && isKnown(s, SP_VMAX) && isKnown(s, SP_A) && v[SP_A] != 0) {
+            derive(s, SP_W, v[SP_VMAX] / v[SP_A], "vmax = A*w");
+        }
+        if (!isKnown(s, SP_W) && isKnown(s, SP_AMAX) && isKnown(s, SP_VMAX) && v[SP_VMAX] != 0) {
+            derive(s, SP_W, v[SP_AMAX] / v[SP_VMAX], "w = amax/vmax");
+        }
+        if (!isKnown(s, SP_W) && isKnown(s, SP_AMAX) && isKnown(s, SP_A) && v[SP_A] != 0 && v[SP_AMAX] / v[SP_A] >= 0) {
+            derive(s, SP_W, sqrtf(v[SP_AMAX] / v[SP_A]), "amax = A*w^2");
+        }
+        if (isKnown(s, SP_W) && v[SP_W] > 0) {
+            if (!isKnown(s, SP_F)) derive(s, SP_F, v[SP_W] / (2 * PI), "f = w/2pi");
+            if (!isKnown(s, SP_T)) derive(s, SP_T, 2 * PI / v[SP_W], "T = 2pi/w");
+        }
+        if (isKnown(s, SP_W) && v[SP_W] > 0) {
+            if (!isKnown(s, SP_K) && isKnown(s, SP_M)) derive(s, SP_K, v[SP_M] * v[SP_W] * v[SP_W], "k = m*w^2");
+            if (!isKnown(s, SP_M) && isKnown(s, SP_K)) derive(s, SP_M, v[SP_K] / (v[SP_W] * v[SP_W]), "m = k/w^2");
+            if (!isKnown(s, SP_A) && isKnown(s, SP_VMAX)) derive(s, SP_A, v[SP_VMAX] / v[SP_W], "A = vmax/w");
+            if (!isKnown(s, SP_A) && isKnown(s, SP_AMAX)) derive(s, SP_A, v[SP_AMAX] / (v[SP_W] * v[SP_W]), "A = amax/w^2");
+        }
+        if (!isKnown(s, SP_A) && isKnown(s, SP_E) && isKnown(s, SP_K) && v[SP_K] > 0 && v[SP_E] >= 0) {
+            derive(s, SP_A, sqrtf(2 * v[SP_E] / v[SP_K]), "A = sqrt(2E/k)");
+        }
+        if (!isKnown(s, SP_VMAX) && isKnown(s, SP_E) && isKnown(s, SP_M) && v[SP_M] > 0 && v[SP_E] >= 0) {
+            derive(s, SP_VMAX, sqrtf(2 * v[SP_E] / v[SP_M]), "vmax = sqrt(2E/m)");
+        }
+        if (isKnown(s, SP_A) && isKnown(s, SP_W)) {
+            if (!isKnown(s, SP_VMAX)) derive(s, SP_VMAX, v[SP_A] * v[SP_W], "vmax = A*w");
+            if (!isKnown(s, SP_AMAX)) derive(s, SP_AMAX, v[SP_A] * v[SP_W] * v[SP_W], "amax = A*w^2");
+        }
+        if (!isKnown(s, SP_E) && isKnown(s, SP_K) && isKnown(s, SP_A)) {
+            derive(s, SP_E, 0.5f * v[SP_K] * v[SP_A] * v[SP_A], "E = k*A^2/2");
+        }
+        if (!isKnown(s, SP_E) && isKnown(s, SP_M) && isKnown(s, SP_VMAX)) {
+            derive(s, SP_E, 0.5f * v[SP_M] * v[SP_VMAX] * v[SP_VMAX], "E = m*vmax^2/2");
+        }
+        if (!isKnown(s, SP_K) && isKnown(s, SP_E) && isKnown(s, SP_A) && v[SP_A] != 0) {
+            derive(s, SP_K, 2 * v[SP_E] / (v[SP_A] * v[SP_A]), "k = 2E/A^2");
+        }
+        if (!isKnown(s, SP_M) && isKnown(s, SP_E) && isKnown(s, SP_VMAX) && v[SP_VMAX] != 0) {
+            derive(s, SP_M, 2 * v[SP_E] / (v[SP_VMAX] * v[SP_VMAX]), "m = 2E/vmax^2");
+        }
+    }
+}
+
+// th0 is kept in degrees in the table and converted here.
+void solvePendulum(OscState& s) {
+    float* v = s.vals;
+    for (int iter = 0; iter < 4; iter++) {
+        if (!isKnown(s, PD_W0) && isKnown(s, PD_G) && isKnown(s, PD_L) && v[PD_L] > 0 && v[PD_G] >= 0) {
+            derive(s, PD_W0, sqrtf(v[PD_G] / v[PD_L]), "w0 = sqrt(g/L)");
+        }
+        if (!isKnown(s, PD_W0) && isKnown(s, PD_T0) && v[PD_T0] > 0) {
+            derive(s, PD_W0, 2 * PI / v[PD_T0], "w0 = 2pi/T0");
+        }
+        if (!isKnown(s, PD_RATIO) && isKnown(s, PD_TH0) && v[PD_TH0] > 0 && v[PD_TH0] < 180) {
+            derive(s, PD_RATIO, periodRatio(v[PD_TH0] * DEG_TO_RAD), "T/T0 = 1/AGM(1,cos(th0/2))");
+        }
+        if (!isKnown(s, PD_RATIO) && isKnown(s, PD_T) && isKnown(s, PD_T0) && v[PD_T0] > 0) {
+            derive(s, PD_RATIO, v[PD_T] / v[PD_T0], "T/T0 = T / T0");
+        }
+        if (!isKnown(s, PD_TH0) && isKnown(s, PD_RATIO) && v[PD_RATIO] >= 1) {
+            derive(s, PD_TH0, amplitudeForRatio(v[PD_RATIO]) * RAD_TO_DEG, "T/T0 = 1/AGM(1,cos(th0/2))");
+        }
+        if (!isKnown(s, PD_W0) && isKnown(s, PD_T) && isKnown(s, PD_RATIO) && v[PD_T] > 0) {
+            derive(s, PD_W0, 2 * PI * v[PD_RATIO] / v[PD_T], "T = T0 * (T/T0)");
+        }
+        if (isKnown(s, PD_W0) && v[PD_W0] > 0) {
+            if (!isKnown(s, PD_T0)) derive(s, PD_T0, 2 * PI / v[PD_W0], "T0 = 2pi/w0");
+            if (!isKnown(s, PD_L) && isKnown(s, PD_G)) derive(s, PD_L, v[PD_G] / (v[PD_W0] * v[PD_W0]), "L = g/w0^2");
+            if (!isKnown(s, PD_G) && isKnown(s, PD_L)) derive(s, PD_G, v[PD_L] * v[PD_W0] * v[PD_W0], "g = L*w0^2");
+        }
+        if (!isKnown(s, PD_T) && isKnown(s, PD_T0) && isKnown(s, PD_RATIO)) {
+            derive(s, PD_T, v[PD_T0] * v[PD_RATIO], "T = T0 * (T/T0)");
+        }
+        if (!isKnown(s, PD_WMAX) && isKnown(s, PD_W0) && isKnown(s, PD_TH0)) {
+            derive(s, PD_WMAX, 2 * v[PD_W0] * sinf(0.5f * v[PD_TH0] * DEG_TO_RAD), "wmax = 2w0*sin(th0/2)");
+        }
+        if (!isKnown(s, PD_WMAX) && isKnown(s, PD_VMAX) && isKnown(s, PD_L) && v[PD_L] > 0) {
+            derive(s, PD_WMAX, v[PD_VMAX] / v[PD_L], "vmax = L*wmax");
+        }
+        if (!isKnown(s, PD_VMAX) && isKnown(s, PD_WMAX) && isKnown(s, PD_L)) {
+            derive(s, PD_VMAX, v[PD_L] * v[PD_WMAX], "vmax = L*wmax");
+        }
+        if (!isKnown(s, PD_TH0) && isKnown(s, PD_WMAX) && isKnown(s, PD_W0) && v[PD_W0] > 0) {
+            float half = v[PD_WMAX] / (2 * v[PD_W0]);
+            if (half >= 0 && half < 1) derive(s, PD_TH0, 2 * asinf(half) * RAD_TO_DEG, "wmax = 2w0*sin(th0/2)");
+        }
+    }
+}
+
+// m x'' + b x' + k x = F0 cos(wdr t). zeta = b / 2m*w0; the steady state is
+// A cos(wdr t - delta). The drive rules only need m, w0 and zeta, so the
+// equations shown use the textbook k and b forms of the same expressions.
+void solveDamped(OscState& s) {
+    float* v = s.vals;
+    for (int iter = 0; iter < 4; iter++) {
+        if (!isKnown(s, DM_W0) && isKnown(s, DM_K) && isKnown(s, DM_M) && v[DM_M] > 0 && v[DM_K] >= 0) {
+            derive(s, DM_W0, sqrtf(v[DM_K] / v[DM_M]), "w0 = sqrt(k/m)");
+        }
+        if (isKnown(s, DM_W0) && v[DM_W0] > 0) {
+            float w0 = v[DM_W0];
+            if (!isKnown(s, DM_K) && isKnown(s, DM_M)) derive(s, DM_K, v[DM_M] * w0 * w0, "k = m*w0^2");
+            if (!isKnown(s, DM_M) && isKnown(s, DM_K)) derive(s, DM_M, v[DM_K] / (w0 * w0), "m = k/w0^2");
+            if (!isKnown(s, DM_ZETA) && isKnown(s, DM_WD) && v[DM_WD] <= w0) {
+                derive(s, DM_ZETA, sqrtf(1 - (v[DM_WD] / w0) * (v[DM_WD] / w0)), "wd = w0*sqrt(1 - zeta^2)");
+            }
+        }
+        if (!isKnown(s, DM_W0) && isKnown(s, DM_WD) && isKnown(s, DM_ZETA) && v[DM_ZETA] < 1) {
+            derive(s, DM_W0, v[DM_WD] / sqrtf(1 - v[DM_ZETA] * v[DM_ZETA]), "wd = w0*sqrt(1 - zeta^2)");
+        }
+        if (isKnown(s, DM_M) && isKnown(s, DM_W0) && v[DM_M] > 0 && v[DM_W0] > 0) {
+            float crit = 2 * v[DM_M] * v[DM_W0];
+            if (!isKnown(s, DM_ZETA) && isKnown(s, DM_B)) derive(s, DM_ZETA, v[DM_B] / crit, "zeta = b / 2m*w0");
+            if (!isKnown(s, DM_B) && isKnown(s, DM_ZETA)) derive(s, DM_B, v[DM_ZETA] * crit, "b = 2m*w0*zeta");
+        }
+        if (!isKnown(s, DM_WD) && isKnown(s, DM_W0) && isKnown(s, DM_ZETA) && v[DM_ZETA] < 1) {
+            derive(s, DM_WD, v[DM_W0] * sqrtf(1 - v[DM_ZETA] * v[DM_ZETA]), "wd = w0*sqrt(1 - zeta^2)");
+        }
+
+        if (!isKnown(s, DM_W0) || !isKnown(s, DM_ZETA) || !isKnown(s, DM_M) || !isKnown(s, DM_WDR)) continue;
+        float w0 = v[DM_W0], w = v[DM_WDR];
+        float re = w0 * w0 - w * w, im = 2 * v[DM_ZETA] * w0 * w;
+        float mag = v[DM_M] * sqrtf(re * re + im * im);
+        if (!isKnown(s, DM_DELTA)) derive(s, DM_DELTA, atan2f(im, re) * RAD_TO_DEG, "tan(delta) = b*wdr / (k - m*wdr^2)");
+        if (!isKnown(s, DM_A) && isKnown(s, DM_F0) && mag > 0) {
+            derive(s, DM_A, v[DM_F0] / mag, "A = F0/sqrt((k-m*wdr^2)^2+(b*wdr)^2)");
+        }
+        if (!isKnown(s, DM_F0) && isKnown(s, DM_A)) {
+            derive(s, DM_F0, v[DM_A] * mag, "A = F0/sqrt((k-m*wdr^2)^2+(b*wdr)^2)");
+        }
+    }
+}
+
+void autoSolve() {
+    OscState& s = systems[curSys];
+    eqUsed[0] = '\0';
+    s.known &= s.userSet;
+    if (curSys == SYS_SPRING) solveSpring(s);
+    else if (curSys == SYS_PENDULUM) solvePendulum(s);
+    else solveDamped(s);
+}
+
+void setCell(int row, bool set, float val) {
+    OscState& s = systems[curSys];
+    s.vals[row] = set ? val : 0;
+    if (set) {
+        s.known |= BIT(row);
+        s.userSet |= BIT(row);
+    } else {
+        s.known &= ~BIT(row);
+        s.userSet &= ~BIT(row);
+    }
+}
+
+// One cycle of the phase curve, sampled once in the orbit's own parameter phi.
+// Spring: x = A sin phi, v = A w cos phi. Pendulum: sin(th/2) = k sin phi and
+// w = 2 w0 k cos phi with k = sin(th0/2), which spaces the samples evenly
+// along the curve with no square roots near the turning points.
+struct PhaseCache {
+    float pos[PHASE_SAMPLES + 1], rate[PHASE_SAMPLES + 1];
+    int16_t sx[PHASE_SAMPLES + 1];
+    uint8_t sy[PHASE_SAMPLES + 1];
+    int16_t linX[PHASE_SAMPLES + 1];
+    uint8_t linY[PHASE_SAMPLES + 1];
+    bool hasLinear;
+};
+
+PhaseCache phase;
+
+bool samplePhase(PhaseCache* c) {
+    const OscState& s = systems[curSys];
+    const float* v = s.vals;
+    float amp, w, k = 0;
+    if (curSys == SYS_SPRING) {
+        if (!isKnown(s, SP_A) || !isKnown(s, SP_W)) return false;
+        amp = v[SP_A];
+        w = v[SP_W];
+    } else {
+        if (!isKnown(s, PD_TH0) || !isKnown(s, PD_W0) || v[PD_TH0] <= 0 || v[PD_TH0] >= 180) return false;
+        amp = v[PD_TH0] * DEG_TO_RAD;
+        w = v[PD_W0];
+        k = sinf(0.5f * amp);
+    }
+    if (amp <= 0 || w <= 0) return false;
+
+    // The small-angle ellipse bounds the exact curve, so it sets the scale.
+    c->hasLinear = curSys == SYS_PENDULUM;
+    int cx = 170, cy = 116;
+    float kx = 130 / (1.1f * amp);
+    float ky = 90 / (1.1f * amp * w);
+    float dPhi = 2 * PI / PHASE_SAMPLES;
+    for (int i = 0; i <= PHASE_SAMPLES; i++) {
+        float sp = sinf(i * dPhi), cp = cosf(i * dPhi);
+        if (c->hasLinear) {
+            c->pos[i] = 2 * asinf(k * sp);
+            c->rate[i] = 2 * w * k * cp;
+            c->linX[i] = (int16_t)(cx + (int)(amp * sp * kx));
+            c->linY[i] = (uint8_t)(cy - (int)(amp * w * cp * ky));
+        } else {
+            c->pos[i] = amp * sp;
+            c->rate[i] = amp * w * cp;
+        }
+        c->sx[i] = (int16_t)(cx + (int)(c->pos[i] * kx));
+        c->sy[i] = (uint8_t)(cy - (int)(c->rate[i] * ky));
+    }
+    return true;
+}
+
+// Phase plot with a trace cursor that walks the cached samples.
+void runPhase() {
+    PhaseCache* c = &phase;
+    if (!samplePhase(c)) {
+        drawMessage(curSys == SYS_SPRING ? "Need A and w" : "Need th0 (0-180) and w0");
+        return;
+    }
+    bool pend = curSys == SYS_PENDULUM;
+    int graphX = 40, graphW = 260, graphTop = 26, graphH = 181;
+    int cx = 170, cy = 116;
+    char buf[15];
+    int cursor = 0;
+    bool running = true;
+    while (running) {
+        gfx_FillScreen(255);
+        gfx_SetColor(200);
+        gfx_Rectangle(graphX, graphTop, graphW, graphH);
+        gfx_HorizLine(graphX, cy, graphW);
+        gfx_VertLine(cx, graphTop, graphH);
+
+        for (int i = 1; i <= PHASE_SAMPLES; i++) {
+            if (c->hasLinear) {
+                gfx_SetColor(181);
+                gfx_Line(c->linX[i - 1], c->linY[i - 1], c->linX[i], c->linY[i]);
+            }
+            gfx_SetColor(24);
+            gfx_Line(c->sx[i - 1], c->sy[i - 1], c->sx[i], c->sy[i]);
+        }
+        gfx_SetColor(224);
+        gfx_FillCircle(c->sx[cursor], c->sy[cursor], 3);
+
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(pend ? "th:" : "x:", 2, 2);
+        floatToStr(pend ? c->pos[cursor] * RAD_TO_DEG : c->pos[cursor], buf);
+        gfx_PrintStringXY(buf, 28, 2);
+        gfx_PrintStringXY(pend ? "w:" : "v:", 160, 2);
+        floatToStr(c->rate[cursor], buf);
+        gfx_PrintStringXY(buf, 178, 2);
+        gfx_PrintStringXY(pend ? "th" : "x", graphX + graphW - 18, cy + 4);
+        gfx_PrintStringXY(pend ? "w" : "v", cx + 4, graphTop + 3);
+        if (c->hasLinear) {
+            gfx_SetTextFGColor(148);
+            gfx_PrintStringXY("gray: small-angle", 2, 13);
+        }
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("left/right: trace  clear: return", 28, 228);
+        gfx_BlitBuffer();
+
+        kb_Scan();
+        if (kb_Data[7] & kb_Left) cursor = (cursor > 0) ? cursor - 1 : PHASE_SAMPLES - 1;
+        if (kb_Data[7] & kb_Right) cursor = (cursor < PHASE_SAMPLES - 1) ? cursor + 1 : 0;
+        if (kb_Data[6] & kb_Clear) running = false;
+    }
+    waitKeyRelease();
+}
+
+// The free response is one of three closed forms, fitted to whatever the
+// steady state leaves of x0 and v0 at t = 0.
+struct DampedMotion {
+    float gamma, wd;
+    float c1, c2;
+    float r1, r2;
+    uint8_t regime;
+    bool driven;
+    float amp, wdr, delta;
+};
+
+const char* regimeNames[3] = {"underdamped", "critical", "overdamped"};
+
+uint8_t sweepRows[SWEEP_COLS + 1];
+
+bool dampedMotion(DampedMotion* d) {
+    const OscState& s = systems[SYS_DAMPED];
+    const float* v = s.vals;
+    if (!isKnown(s, DM_W0) || !isKnown(s, DM_ZETA) || v[DM_W0] <= 0 || v[DM_ZETA] < 0) return false;
+    float w0 = v[DM_W0], zeta = v[DM_ZETA];
+    d->gamma = zeta * w0;
+    d->driven = isKnown(s, DM_A) && isKnown(s, DM_WDR) && isKnown(s, DM_DELTA);
+    d->amp = d->driven ? v[DM_A] : 0;
+    d->wdr = d->driven ? v[DM_WDR] : 0;
+    d->delta = d->driven ? v[DM_DELTA] * DEG_TO_RAD : 0;
+
+    float x0 = isKnown(s, DM_X0) ? v[DM_X0] : 0;
+    float v0 = isKnown(s, DM_V0) ? v[DM_V0] : 0;
+    x0 -= d->amp * cosf(-d->delta);
+    v0 += d->amp * d->wdr * sinf(-d->delta);
+
+    if (fabsf(zeta - 1) < CRITICAL_BAND) {
+        d->regime = REGIME_CRITICAL;
+        d->c1 = x0;
+        d->c2 = v0 + d->gamma * x0;
+    } else if (zeta < 1) {
+        d->regime = REGIME_UNDER;
+        d->wd = w0 * sqrtf(1 - zeta * zeta);
+        d->c1 = x0;
+        d->c2 = (v0 + d->gamma * x0) / d->wd;
+    } else {
+        d->regime = REGIME_OVER;
+        float root = w0 * sqrtf(zeta * zeta - 1);
+        // The slow root from the root product w0^2, since -gamma + root
+        // cancels when heavily overdamped.
+        d->r2 = -d->gamma - root;
+        d->r1 = w0 * w0 / d->r2;
+        d->c1 = (v0 - d->r2 * x0) / (d->r1 - d->r2);
+        d->c2 = x0 - d->c1;
+    }
+    return true;
+}
+
+float transientAt(const DampedMotion* d, float t) {
+    if (d->regime == REGIME_OVER) return d->c1 * expf(d->r1 * t) + d->c2 * expf(d->r2 * t);
+    float decay = expf(-d->gamma * t);
+    if (d->regime == REGIME_CRITICAL) return (d->c1 + d->c2 * t) * decay;
+    return decay * (d->c1 * cosf(d->wd * t) + d->c2 * sinf(d->wd * t));
+}
+
+float steadyAt(const DampedMotion* d, float t) {
+    return d->driven ? d->amp * cosf(d->wdr * t - d->delta) : 0;
+}
+
+// x(t) straight from the closed forms, one evaluation per pixel column, with
+// the underdamped envelope and the steady state drawn behind it.
+void runDamped() {
+    DampedMotion d;
+    if (!dampedMotion(&d)) {
+        drawMessage("Need w0 and zeta");
+        return;
+    }
+    float w0 = systems[SYS_DAMPED].vals[DM_W0];
+    float wSlow = (d.driven && d.wdr > 0 && d.wdr < w0) ? d.wdr : w0;
+    float tEnd = 5 * 2 * PI / wSlow;
+    if (!d.driven && d.gamma > 0 && 5 / d.gamma < tEnd) tEnd = 5 / d.gamma;
+    if (tEnd < 2 * PI / w0) tEnd = 2 * PI / w0;
+
+    int graphX = 30, graphW = 280, graphTop = 26, half = 88;
+    int mid = graphTop + half;
+    float envAmp = sqrtf(d.c1 * d.c1 + d.c2 * d.c2);
+    float xMax = fabsf(d.amp) + (d.regime == REGIME_UNDER ? envAmp : fabsf(d.c1) + fabsf(d.c2));
+    if (xMax <= 0) xMax = 1;
+    float ky = half / (1.1f * xMax);
+    float dt = tEnd / graphW;
+
+    char buf[15];
+    gfx_FillScreen(255);
+    gfx_SetColor(200);
+    gfx_Rectangle(graphX, graphTop, graphW, 2 * half + 1);
+    gfx_HorizLine(graphX, mid, graphW);
+
+    int prevY = 0, prevSteady = 0;
+    for (int i = 0; i <= graphW; i++) {
+        float t = i * dt;
+        float xs = steadyAt(&d, t);
+        int sy = mid - (int)(xs * ky);
+        int y = mid - (int)((transientAt(&d, t) + xs) * ky);
+        if (d.regime == REGIME_UNDER && d.gamma > 0 && (i & 3) == 0) {
+            int e = (int)(envAmp * expf(-d.gamma * t) * ky);
+            gfx_SetColor(181);
+            gfx_SetPixel(graphX + i, mid - e);
+            gfx_SetPixel(graphX + i, mid + e);
+        }
+        if (i > 0) {
+            if (d.driven) {
+                gfx_SetColor(231);
+                gfx_Line(graphX + i - 1, prevSteady, graphX + i, sy);
+            }
+            gfx_SetColor(24);
+            gfx_Line(graphX + i - 1, prevY, graphX + i, y);
+        }
+        prevY = y;
+        prevSteady = sy;
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY(regimeNames[d.regime], 2, 2);
+    if (d.driven) {
+        gfx_PrintStringXY("A:", 160, 2);
+        floatToStr(d.amp, buf);
+        gfx_PrintStringXY(buf, 178, 2);
+        gfx_PrintStringXY("delta:", 160, 13);
+        floatToStr(d.delta * RAD_TO_DEG, buf);
+        gfx_PrintStringXY(buf, 210, 13);
+    }
+    floatToStr(xMax * 1.1f, buf);
+    gfx_PrintStringXY(buf, graphX + 2, graphTop + 2);
+    gfx_PrintStringXY("t:", 230, graphTop + 2 * half + 5);
+    floatToStr(tEnd, buf);
+    gfx_PrintStringXY(buf, 248, graphTop + 2 * half + 5);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("Any key to return", 101, 228);
+    gfx_BlitBuffer();
+
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+// Magnification A*k/F0 = w0^2 / sqrt((w0^2 - w^2)^2 + (2*gamma*w)^2) from 0 to
+// SWEEP_SPAN*w0. w^2 is stepped by odd multiples of dw^2, so each column costs
+// two multiplies and a square root.
+void runSweep() {
+    DampedMotion d;
+    if (!dampedMotion(&d)) {
+        drawMessage("Need w0 and zeta");
+        return;
+    }
+    const OscState& s = systems[SYS_DAMPED];
+    float w0 = s.vals[DM_W0];
+    float w02 = w0 * w0, g2 = 4 * d.gamma * d.gamma;
+    float zeta = s.vals[DM_ZETA];
+    float peak = (zeta < 0.7071f) ? 1 / (2 * zeta * sqrtf(1 - zeta * zeta)) : 1;
+    bool hasForce = isKnown(s, DM_F0) && isKnown(s, DM_K) && s.vals[DM_K] > 0;
+
+    int graphX = 30, graphW = SWEEP_COLS, graphTop = 26, graphH = 180;
+    int bottom = graphTop + graphH;
+    float yMax = (peak < 20) ? 1.1f * peak : 22;
+    float ky = graphH / yMax;
+    float dw = SWEEP_SPAN * w0 / graphW;
+    float dw2 = dw * dw;
+
+    float u = 0, du = dw2;
+    for (int i = 0; i <= graphW; i++) {
+        float re = w02 - u;
+        // Clipped in float first: with zeta = 0 the peak is infinite, too
+        // big for an int.
+        float h = w02 / sqrtf(re * re + g2 * u) * ky;
+        if (!(h < graphH)) h = graphH;
+        sweepRows[i] = (uint8_t)(bottom - (int)h);
+        u += du;
+        du += 2 * dw2;
+    }
+
+    char buf[15];
+    int cursor = (int)(graphW / SWEEP_SPAN);
+    if (d.driven && d.wdr < SWEEP_SPAN * w0) cursor = (int)(d.wdr / dw);
+    bool running = true;
+    while (running) {
+        gfx_FillScreen(255);
+        gfx_SetColor(200);
+        gfx_Rectangle(graphX, graphTop, graphW + 1, graphH + 1);
+        gfx_VertLine(graphX + graphW / SWEEP_SPAN, graphTop, graphH);
+        gfx_SetColor(24);
+        for (int i = 1; i <= graphW; i++) gfx_Line(graphX + i - 1, sweepRows[i - 1], graphX + i, sweepRows[i]);
+        gfx_SetColor(224);
+        gfx_VertLine(graphX + cursor, graphTop, graphH);
+        gfx_FillCircle(graphX + cursor, sweepRows[cursor], 2);
+
+        float w = cursor * dw;
+        float re = w02 - w * w;
+        float mag = w02 / sqrtf(re * re + g2 * w * w);
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("wdr:", 2, 2);
+        floatToStr(w, buf);
+        gfx_PrintStringXY(buf, 36, 2);
+        gfx_PrintStringXY(hasForce ? "A:" : "Ak/F0:", 150, 2);
+        floatToStr(hasForce ? mag * s.vals[DM_F0] / s.vals[DM_K] : mag, buf);
+        gfx_PrintStringXY(buf, hasForce ? 168 : 200, 2);
+        gfx_PrintStringXY("delta:", 2, 13);
+        floatToStr(atan2f(2 * d.gamma * w, re) * RAD_TO_DEG, buf);
+        gfx_PrintStringXY(buf, 52, 13);
+        gfx_PrintStringXY("peak:", 150, 13);
+        floatToStr(peak, buf);
+        gfx_PrintStringXY(buf, 192, 13);
+        gfx_PrintStringXY("w0", graphX + graphW / SWEEP_SPAN - 6, bottom + 4);
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("left/right: trace  clear: return", 28, 228);
+        gfx_BlitBuffer();
+
+        kb_Scan();
+        if ((kb_Data[7] & kb_Left) && cursor > 0) cursor--;
+        if ((kb_Data[7] & kb_Right) && cursor < graphW) cursor++;
+        if (kb_Data[6] & kb_Clear) running = false;
+    }
+    waitKeyRelease();
+}
+
+void drawTable() {
+    const OscState& s = systems[curSys];
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("OSCILLATIONS - Evan Kolberg", 60, 3);
+
+    int startX = 5;
+    int startY = 16;
+    int rowH = 15;
+    int labelW = 40;
+    int boxW = 84;
+
+    for (int row = 0; row < oscRows[curSys]; row++) {
+        int y = startY + row * rowH;
+        bool selected = (row == curRow && !inputMode);
+        bool editing = (row == curRow && inputMode);
+        int x = startX + labelW;
+
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(oscLabels[curSys][row], startX + 2, y + 3);
+
+        if (selected) {
+            gfx_SetColor(183);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        } else if (editing) {
+            gfx_SetColor(239);
+            gfx_FillRectangle(x, y, boxW, rowH - 2);
+        }
+        gfx_SetColor(0);
+        gfx_Rectangle(x, y, boxW, rowH - 2);
+
+        char buf[15];
+        if (editing) {
+            inputText(buf);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else if (isKnown(s, row)) {
+            floatToStr(s.vals[row], buf);
+            gfx_SetTextFGColor((s.userSet & BIT(row)) ? 0 : 24);
+            gfx_PrintStringXY(buf, x + 3, y + 3);
+        } else {
+            gfx_PrintStringXY("?", x + boxW / 2 - 4, y + 3);
+        }
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(oscUnits[curSys][row], x + boxW + 4, y + 3);
+    }
+
+    int rightX = 180;
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY(oscTitles[curSys], rightX, startY + 3);
+    if (curSys == SYS_DAMPED && isKnown(s, DM_ZETA)) {
+        float zeta = s.vals[DM_ZETA];
+        int regime = (fabsf(zeta - 1) < CRITICAL_BAND) ? REGIME_CRITICAL : (zeta < 1 ? REGIME_UNDER : REGIME_OVER);
+        gfx_PrintStringXY(regimeNames[regime], rightX, startY + rowH + 3);
+    }
+    gfx_PrintStringXY("y=: switch system", rightX, startY + 3 * rowH);
+    gfx_PrintStringXY(curSys == SYS_DAMPED ? "graph: x vs t" : "graph: phase plot", rightX, startY + 4 * rowH);
+    if (curSys == SYS_DAMPED) gfx_PrintStringXY("window: resonance", rightX, startY + 5 * rowH);
+    gfx_PrintStringXY(",: EE (x10^)", rightX, startY + 6 * rowH);
+    gfx_PrintStringXY("del: clear cell", rightX, startY + 7 * rowH);
+    gfx_PrintStringXY("mode: reset", rightX, startY + 8 * rowH);
+    gfx_PrintStringXY("clear: quit", rightX, startY + 9 * rowH);
+
+    int eqY = startY + oscRows[curSys] * rowH + 4;
+    printEqList(eqUsed, eqY);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(curRow, true, parseInput());
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, false, 0);
+    autoSolve();
+}
+
+// systems goes first, as WORKEN reads it back on its own.
+const ModChunk stateChunks[] = {
+    {systems, sizeof(systems)},
+    {&curSys, sizeof(curSys)},
+    {eqUsed, sizeof(eqUsed)}
+};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(OSC_STATE_VAR);
+    if (!resume || !loadModState(OSC_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevEnter = false, prevClear = false, prevDel = false;
+    bool prevMode = false, prevGraph = false, prevWindow = false, prevYequ = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool window = kb_Data[1] & kb_Window;
+        bool yequ = kb_Data[1] & kb_Yequ;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (yequ && !prevYequ) {
+                curSys = (curSys + 1) % SYS_COUNT;
+                curRow = 0;
+                autoSolve();
+            }
+            if (graph && !prevGraph) {
+                if (curSys == SYS_DAMPED) runDamped();
+                else runPhase();
+            }
+            if (window && !prevWindow && curSys == SYS_DAMPED) runSweep();
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        curRow = (curRow + move + oscRows[curSys]) % oscRows[curSys];
+
+        prevUp = up; prevDown = down; prevEnter = enter; prevClear = clear; prevDel = del;
+        prevMode = mode; prevGraph = graph; prevWindow = window; prevYequ = yequ; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(OSC_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
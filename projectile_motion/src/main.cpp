@@ -2,368 +2,424 @@
 #include <graphx.h>
 #include <keypadc.h>
 #include <ti/real.h>
+#include <fileioc.h>
 #include <string.h>
 #include <math.h>
 
+#include "numfmt.h"
+#include "kinematics.h"
+#include "linsolve.h"
+#include "modstate.h"
+#include "listview.h"
+#include "degtrig.h"
+#include "tableinput.h"
+
 #define GRAVITY 9.81f
 #define PI 3.14159265f
 #define DEG_TO_RAD (PI / 180.0f)
 #define RAD_TO_DEG (180.0f / PI)
 
-#define VAR_COUNT 7
 #define ROWS 7
 #define COLS 2
 
-float xVals[VAR_COUNT];
-float yVals[VAR_COUNT];
-bool xKnown[VAR_COUNT];
-bool yKnown[VAR_COUNT];
-bool xUserSet[VAR_COUNT];
-bool yUserSet[VAR_COUNT];
-
-float launchSpeed = 0;
-float launchAngle = 0;
-float finalSpeed = 0;
-bool speedKnown = false;
-bool angleKnown = false;
-bool finalSpeedKnown = false;
-bool speedUserSet = false;
-bool angleUserSet = false;
-bool finalSpeedUserSet = false;
+ProjState<float> st;
 
 int curRow = 0;
 int curCol = 0;
-char inputBuf[12];
-int inputLen = 0;
-bool inputMode = false;
-bool hasDecimal = false;
-bool isNegative = false;
 
 const char* rowLabels[VAR_COUNT] = {"p0", "pf", "v0", "vf", "a", "d", "t"};
+const char* extraShortLabels[EXTRA_COUNT] = {"|v0|", "ang", "|vf|"};
+const char* cellUnits[ROWS + EXTRA_COUNT] = {"m", "m", "m/s", "m/s", "m/s^2", "m", "s", "m/s", "deg", "m/s"};
 
 char xEqUsed[64] = "";
 char yEqUsed[64] = "";
 
-void floatToStr(float val, char* out) {
-    real_t r = os_FloatToReal(val);
-    os_RealToStr(out, &r, 8, 1, 3);
-    for (int i = 0; out[i]; i++) {
-        if (out[i] == '\032') out[i] = '-';
-    }
+void initData(ProjState<float>& s = st) {
+    memset(&s, 0, sizeof(s));
+    s.xVals[0] = 0;
+    s.xVals[4] = 0;
+    s.xKnown = s.xUserSet = BIT(0) | BIT(4);
+    s.yVals[4] = -GRAVITY;
+    s.yKnown = s.yUserSet = BIT(4);
 }
 
-void initData() {
-    for (int i = 0; i < VAR_COUNT; i++) {
-        xVals[i] = 0;
-        yVals[i] = 0;
-        xKnown[i] = false;
-        yKnown[i] = false;
-        xUserSet[i] = false;
-        yUserSet[i] = false;
-    }
-    xVals[0] = 0;
-    xKnown[0] = true;
-    xUserSet[0] = true;
-    xVals[4] = 0;
-    xKnown[4] = true;
-    xUserSet[4] = true;
-    yVals[4] = -GRAVITY;
-    yKnown[4] = true;
-    yUserSet[4] = true;
-    
-    launchSpeed = 0;
-    launchAngle = 0;
-    finalSpeed = 0;
-    speedKnown = false;
-    angleKnown = false;
-    finalSpeedKnown = false;
-    speedUserSet = false;
-    angleUserSet = false;
-    finalSpeedUserSet = false;
-}
+template <typename T>
+void autoSolve(ProjState<T>& s, char* xEq, char* yEq) {
+    if (xEq) xEq[0] = '\0';
+    if (yEq) yEq[0] = '\0';
+
+    s.xKnown &= s.xUserSet;
+    s.yKnown &= s.yUserSet;
+    s.extraKnown &= s.extraUserSet;
 
-void addEq(char* eqUsed, const char* eq) {
-    if (strstr(eqUsed, eq) != NULL) return;
-    if (eqUsed[0] == '\0') {
-        strcpy(eqUsed, eq);
-    } else if (strlen(eqUsed) + strlen(eq) + 2 < 60) {
-        strcat(eqUsed, "|");
-        strcat(eqUsed, eq);
+    if ((s.extraUserSet & BIT(EX_SPEED)) && (s.extraUserSet & BIT(EX_ANGLE))) {
+        T rad = s.extraVals[EX_ANGLE] * (T)DEG_TO_RAD;
+        s.xVals[2] = s.extraVals[EX_SPEED] * cosT(rad);
+        s.yVals[2] = s.extraVals[EX_SPEED] * sinT(rad);
+        s.xSig[2] = s.ySig[2] = sigMin(s.extraSig[EX_SPEED], s.extraSig[EX_ANGLE]);
+        s.xKnown |= BIT(2);
+        s.yKnown |= BIT(2);
     }
-}
 
-void trySolve(float* vals, bool* known, bool* userSet, char* eqUsed) {
-    float p0 = vals[0], pf = vals[1], v0 = vals[2], vf = vals[3], a = vals[4], d = vals[5], t = vals[6];
-    bool kp0 = known[0], kpf = known[1], kv0 = known[2], kvf = known[3], ka = known[4], kd = known[5], kt = known[6];
-    
-    for (int iter = 0; iter < 20; iter++) {
-        if (!kd && kp0 && kpf) {
-            d = pf - p0;
-            kd = true;
-            addEq(eqUsed, "d = pf - p0");
-        }
-        if (!kpf && kp0 && kd) {
-            pf = p0 + d;
-            kpf = true;
-            addEq(eqUsed, "pf = p0 + d");
-        }
-        if (!kp0 && kpf && kd) {
-            p0 = pf - d;
-            kp0 = true;
-            addEq(eqUsed, "p0 = pf - d");
-        }
-        if (!kt && kv0 && kvf && ka && a != 0) {
-            t = (vf - v0) / a;
-            if (t >= 0) { kt = true; addEq(eqUsed, "t = (vf - v0) / a"); }
-        }
-        if (!kvf && kv0 && ka && a == 0) {
-            vf = v0;
-            kvf = true;
-            addEq(eqUsed, "vf = v0 (a=0)");
-        }
-        if (!kv0 && kvf && ka && a == 0) {
-            v0 = vf;
-            kv0 = true;
-            addEq(eqUsed, "v0 = vf (a=0)");
-        }
-        if (!kvf && kv0 && ka && kt) {
-            vf = v0 + a * t;
-            kvf = true;
-            addEq(eqUsed, "vf = v0 + a*t");
-        }
-        if (!kv0 && kvf && ka && kt) {
-            v0 = vf - a * t;
-            kv0 = true;
-            addEq(eqUsed, "v0 = vf - a*t");
-        }
-        if (!ka && kv0 && kvf && kt && t != 0) {
-            a = (vf - v0) / t;
-            ka = true;
-            addEq(eqUsed, "a = (vf - v0) / t");
-        }
-        if (!kd && kv0 && kt && ka) {
-            d = v0 * t + 0.5f * a * t * t;
-            kd = true;
-            addEq(eqUsed, "d = v0*t + .5*a*t^2");
-        }
-        if (!kv0 && kd && kt && ka && t != 0) {
-            v0 = (d - 0.5f * a * t * t) / t;
-            kv0 = true;
-            addEq(eqUsed, "v0 = (d - .5*a*t^2) / t");
-        }
-        if (!ka && kv0 && kd && kt && t != 0) {
-            a = 2 * (d - v0 * t) / (t * t);
-            ka = true;
-            addEq(eqUsed, "a = 2(d - v0*t) / t^2");
-        }
-        if (!kd && kv0 && kvf && kt) {
-            d = (v0 + vf) * 0.5f * t;
-            kd = true;
-            addEq(eqUsed, "d = (v0 + vf) * t / 2");
-        }
-        if (!kt && kv0 && kvf && kd && (v0 + vf) != 0) {
-            t = 2 * d / (v0 + vf);
-            if (t >= 0) { kt = true; addEq(eqUsed, "t = 2*d / (v0 + vf)"); }
-        }
-        if (!kv0 && kvf && kd && kt && t != 0) {
-            v0 = 2 * d / t - vf;
-            kv0 = true;
-            addEq(eqUsed, "v0 = 2*d / t - vf");
+    T vfMag = s.extraVals[EX_VF];
+    if ((s.extraUserSet & BIT(EX_VF)) && (s.xKnown & BIT(3)) && !(s.yUserSet & BIT(3))) {
+        T vfx = s.xVals[3];
+        T vfy_sq = vfMag * vfMag - vfx * vfx;
+        if (vfy_sq >= 0) {
+            s.yVals[3] = -sqrtT(vfy_sq);
+            s.ySig[3] = sigMin(s.extraSig[EX_VF], s.xSig[3]);
+            s.yKnown |= BIT(3);
         }
-        if (!kvf && kv0 && kd && kt && t != 0) {
-            vf = 2 * d / t - v0;
-            kvf = true;
-            addEq(eqUsed, "vf = 2*d / t - v0");
+    }
+    if ((s.extraUserSet & BIT(EX_VF)) && (s.yKnown & BIT(3)) && !(s.xUserSet & BIT(3))) {
+        T vfy = s.yVals[3];
+        T vfx_sq = vfMag * vfMag - vfy * vfy;
+        if (vfx_sq >= 0) {
+            s.xVals[3] = sqrtT(vfx_sq);
+            s.xSig[3] = sigMin(s.extraSig[EX_VF], s.ySig[3]);
+            s.xKnown |= BIT(3);
         }
+    }
 
-        if (!kd && kvf && kt && ka) {
-            d = vf * t - 0.5f * a * t * t;
-            kd = true;
-            addEq(eqUsed, "d = vf*t - .5*a*t^2");
-        }
-        if (!kvf && kd && kt && ka && t != 0) {
-            vf = (d + 0.5f * a * t * t) / t;
-            kvf = true;
-            addEq(eqUsed, "vf = (d + .5*a*t^2) / t");
-        }
-        if (!ka && kvf && kd && kt && t != 0) {
-            a = 2 * (vf * t - d) / (t * t);
-            ka = true;
-            addEq(eqUsed, "a = 2(vf*t - d) / t^2");
-        }
-        if (!kt && kvf && kd && ka) {
-            if (a != 0) {
-                float disc = vf * vf - 2 * a * d;
-                if (disc >= 0) {
-                    float t1 = (vf - sqrtf(disc)) / a;
-                    float t2 = (vf + sqrtf(disc)) / a;
-                    float tMax = (t1 > t2) ? t1 : t2;
-                    float tMin = (t1 < t2) ? t1 : t2;
-                    if (tMax > 0.001f) {
-                        t = tMax;
-                        kt = true;
-                    } else if (tMin >= 0) {
-                        t = tMin;
-                        kt = true;
-                    }
-                    if (kt) addEq(eqUsed, "d = vf*t - .5*a*t^2");
-                }
-            } else if (vf != 0) {
-                t = d / vf;
-                if (t >= 0) { kt = true; addEq(eqUsed, "t = d / vf"); }
-            }
-        }
-        if (!kt && kv0 && kd && ka) {
-            if (a != 0) {
-                float disc = v0 * v0 + 2 * a * d;
-                if (disc >= 0) {
-                    float t1 = (-v0 + sqrtf(disc)) / a;
-                    float t2 = (-v0 - sqrtf(disc)) / a;
-                    float tMax = (t1 > t2) ? t1 : t2;
-                    float tMin = (t1 < t2) ? t1 : t2;
-                    if (tMax > 0.001f) {
-                        t = tMax;
-                        kt = true;
-                    } else if (tMin >= 0) {
-                        t = tMin;
-                        kt = true;
-                    }
-                    if (kt) addEq(eqUsed, "d = v0*t + .5*a*t^2");
-                }
-            } else if (v0 != 0) {
-                t = d / v0;
-                if (t >= 0) { kt = true; addEq(eqUsed, "t = d / v0"); }
-            }
-        }
-        if (!kvf && kv0 && ka && kd) {
-            float disc = v0 * v0 + 2 * a * d;
-            if (disc >= 0) {
-                float vfMag = sqrtf(disc);
-                if (v0 != 0) vf = (v0 > 0) ? vfMag : -vfMag;
-                else vf = (a * d >= 0) ? vfMag : -vfMag;
-                kvf = true;
-                addEq(eqUsed, "vf^2 = v0^2 + 2*a*d");
-            }
-        }
-        if (!kv0 && kvf && ka && kd) {
-            float disc = vf * vf - 2 * a * d;
-            if (disc >= 0) {
-                float v0Mag = sqrtf(disc);
-                if (vf != 0) v0 = (vf > 0) ? v0Mag : -v0Mag;
-                else v0 = (a * d <= 0) ? v0Mag : -v0Mag;
-                kv0 = true;
-                addEq(eqUsed, "v0^2 = vf^2 - 2*a*d");
-            }
-        }
-        if (!ka && kv0 && kvf && kd && d != 0) {
-            a = (vf * vf - v0 * v0) / (2 * d);
-            ka = true;
-            addEq(eqUsed, "a = (vf^2 - v0^2) / 2*d");
+    if ((s.xUserSet & BIT(6)) && !(s.yUserSet & BIT(6))) {
+        s.yVals[6] = s.xVals[6];
+        s.ySig[6] = s.xSig[6];
+        s.yKnown |= BIT(6);
+    } else if ((s.yUserSet & BIT(6)) && !(s.xUserSet & BIT(6))) {
+        s.xVals[6] = s.yVals[6];
+        s.xSig[6] = s.ySig[6];
+        s.xKnown |= BIT(6);
+    }
+
+    // With no horizontal acceleration, which is the default, x only needs the
+    // constant-velocity rules. A user-entered a_x gets the full solver.
+    bool xUniform = (s.xUserSet & BIT(4)) && s.xVals[4] == 0;
+    for (int pass = 0; pass < 3; pass++) {
+        if (xUniform) s.xKnown = trySolve<LinearNames, true>(s.xVals, s.xSig, s.xKnown, s.xUserSet, xEq);
+        else s.xKnown = trySolve(s.xVals, s.xSig, s.xKnown, s.xUserSet, xEq);
+
+        if ((s.xKnown & BIT(6)) && !(s.yKnown & BIT(6))) {
+            s.yVals[6] = s.xVals[6];
+            s.ySig[6] = s.xSig[6];
+            s.yKnown |= BIT(6);
         }
-        if (!kd && kv0 && kvf && ka && a != 0) {
-            d = (vf * vf - v0 * v0) / (2 * a);
-            kd = true;
-            addEq(eqUsed, "d = (vf^2 - v0^2) / 2*a");
+
+        s.yKnown = trySolve(s.yVals, s.ySig, s.yKnown, s.yUserSet, yEq);
+
+        if ((s.yKnown & BIT(6)) && !(s.xKnown & BIT(6))) {
+            s.xVals[6] = s.yVals[6];
+            s.xSig[6] = s.ySig[6];
+            s.xKnown |= BIT(6);
         }
     }
-    
-    vals[0] = p0; vals[1] = pf; vals[2] = v0; vals[3] = vf; vals[4] = a; vals[5] = d; vals[6] = t;
-    
-    for (int i = 0; i < VAR_COUNT; i++) {
-        bool nowKnown = false;
-        switch(i) {
-            case 0: nowKnown = kp0; break;
-            case 1: nowKnown = kpf; break;
-            case 2: nowKnown = kv0; break;
-            case 3: nowKnown = kvf; break;
-            case 4: nowKnown = ka; break;
-            case 5: nowKnown = kd; break;
-            case 6: nowKnown = kt; break;
-        }
-        if (!userSet[i] && nowKnown) known[i] = true;
+
+    bool v0Known = (s.xKnown & BIT(2)) && (s.yKnown & BIT(2));
+    uint8_t v0Sig = sigMin(s.xSig[2], s.ySig[2]);
+    if (!(s.extraKnown & BIT(EX_SPEED)) && v0Known) {
+        s.extraSig[EX_SPEED] = v0Sig;
+        s.extraVals[EX_SPEED] = sqrtT(s.xVals[2] * s.xVals[2] + s.yVals[2] * s.yVals[2]);
+        s.extraKnown |= BIT(EX_SPEED);
+    }
+    if (!(s.extraKnown & BIT(EX_ANGLE)) && v0Known) {
+        s.extraSig[EX_ANGLE] = v0Sig;
+        s.extraVals[EX_ANGLE] = atan2T(s.yVals[2], s.xVals[2]) * (T)RAD_TO_DEG;
+        s.extraKnown |= BIT(EX_ANGLE);
+    }
+    if (!(s.extraKnown & BIT(EX_VF)) && (s.xKnown & BIT(3)) && (s.yKnown & BIT(3))) {
+        s.extraVals[EX_VF] = sqrtT(s.xVals[3] * s.xVals[3] + s.yVals[3] * s.yVals[3]);
+        s.extraSig[EX_VF] = sigMin(s.xSig[3], s.ySig[3]);
+        s.extraKnown |= BIT(EX_VF);
     }
 }
 
 void autoSolve() {
-    xEqUsed[0] = '\0';
-    yEqUsed[0] = '\0';
-    
-    for (int i = 0; i < VAR_COUNT; i++) {
-        if (!xUserSet[i]) xKnown[i] = false;
-        if (!yUserSet[i]) yKnown[i] = false;
+    autoSolve(st, xEqUsed, yEqUsed);
+}
+
+#define FX_SHIFT 16
+#define FX_ONE (1L << FX_SHIFT)
+
+// World-to-screen mapping of one viewport, computed once so that plotting a
+// point needs no divides. Screen y grows downwards from bottom.
+struct ScreenMap {
+    float minX, minY;
+    float kx, ky;
+    int left, bottom;
+};
+
+// Screen coordinates of a constant-acceleration path as fixed-point quadratics
+// in the sample index, so each sample projects with integer multiply-shifts.
+struct TrajPlot {
+    int32_t x0, x1, x2;
+    int32_t y0, y1, y2;
+};
+
+void trajExtent(float p0, float v, float a, float tEnd, float* lo, float* hi) {
+    float pEnd = p0 + v * tEnd + 0.5f * a * tEnd * tEnd;
+    *lo = (p0 < pEnd) ? p0 : pEnd;
+    *hi = (p0 < pEnd) ? pEnd : p0;
+    if (a != 0) {
+        float tTurn = -v / a;
+        if (tTurn > 0 && tTurn < tEnd) {
+            float pTurn = p0 + 0.5f * v * tTurn;
+            if (pTurn < *lo) *lo = pTurn;
+            if (pTurn > *hi) *hi = pTurn;
+        }
     }
-    if (!speedUserSet) speedKnown = false;
-    if (!angleUserSet) angleKnown = false;
-    if (!finalSpeedUserSet) finalSpeedKnown = false;
-    
-    if (speedUserSet && angleUserSet) {
-        xVals[2] = launchSpeed * cosf(launchAngle * DEG_TO_RAD);
-        yVals[2] = launchSpeed * sinf(launchAngle * DEG_TO_RAD);
-        xKnown[2] = true;
-        yKnown[2] = true;
+}
+
+// Pads the box by 10% and widens one axis so both share the same scale.
+void fitViewport(ScreenMap* m, float minX, float maxX, float minY, float maxY, int left, int bottom, int w, int h) {
+    float rangeX = maxX - minX;
+    float rangeY = maxY - minY;
+    if (rangeX < 0.1f) rangeX = 0.1f;
+    if (rangeY < 0.1f) rangeY = 0.1f;
+    float centerX = minX + 0.5f * (maxX - minX);
+    float centerY = minY + 0.5f * (maxY - minY);
+
+    float scale = 1.2f * rangeX / w;
+    if (1.2f * rangeY / h > scale) scale = 1.2f * rangeY / h;
+    m->kx = m->ky = 1 / scale;
+    m->minX = centerX - 0.5f * scale * w;
+    m->minY = centerY - 0.5f * scale * h;
+    m->left = left;
+    m->bottom = bottom;
+}
+
+int mapX(const ScreenMap* m, float x) {
+    return m->left + (int)((x - m->minX) * m->kx);
+}
+
+int mapY(const ScreenMap* m, float y) {
+    return m->bottom - (int)((y - m->minY) * m->ky);
+}
+
+void initTrajPlot(TrajPlot* p, const ScreenMap* m, float x0, float vx, float ax, float y0, float vy, float ay, float dt) {
+    p->x0 = (int32_t)((m->left + (x0 - m->minX) * m->kx) * FX_ONE) + FX_ONE / 2;
+    p->x1 = (int32_t)(vx * dt * m->kx * FX_ONE);
+    p->x2 = (int32_t)(0.5f * ax * dt * dt * m->kx * FX_ONE);
+    p->y0 = (int32_t)((m->bottom - (y0 - m->minY) * m->ky) * FX_ONE) + FX_ONE / 2;
+    p->y1 = (int32_t)(-vy * dt * m->ky * FX_ONE);
+    p->y2 = (int32_t)(-0.5f * ay * dt * dt * m->ky * FX_ONE);
+}
+
+int trajX(const TrajPlot* p, int i) {
+    return (int)((p->x0 + i * (p->x1 + i * p->x2)) >> FX_SHIFT);
+}
+
+int trajY(const TrajPlot* p, int i) {
+    return (int)((p->y0 + i * (p->y1 + i * p->y2)) >> FX_SHIFT);
+}
+
+#define FIT_NONE 0
+#define FIT_TIME 1
+#define FIT_SHAPE 2
+
+#define FIT_MAX_POINTS 999
+#define ROBUST_SAMPLE 64
+#define ROBUST_ITERS 24
+
+// Streaming normal equations for p(u) = c0 + c1*u + c2*u^2, so no points
+// are copied out of the lists.
+struct QuadFit {
+    float su[5];
+    float sy[3];
+    int n;
+};
+
+struct LabFit {
+    uint8_t mode;
+    bool hasX;
+    bool robust;
+    int n;
+    int rejected;
+    float minX, maxX, minY, maxY;
+    float p0x, p0y, v0x, v0y, ay, span, rms;
+};
+
+LabFit labFit;
+uint8_t fitRejected[(FIT_MAX_POINTS + 7) / 8];
+
+void fitAdd(QuadFit* f, float u, float y) {
+    float uk = 1;
+    for (int k = 0; k < 5; k++) {
+        f->su[k] += uk;
+        if (k < 3) f->sy[k] += uk * y;
+        uk *= u;
     }
-    
-    if (finalSpeedUserSet && xKnown[3] && !yUserSet[3]) {
-        float vfx = xVals[3];
-        float vfy_sq = finalSpeed * finalSpeed - vfx * vfx;
-        if (vfy_sq >= 0) {
-            yVals[3] = -sqrtf(vfy_sq);
-            yKnown[3] = true;
+    f->n++;
+}
+
+// Least-squares polynomial of the given degree (1 or 2) from the sums.
+bool fitSolve(const QuadFit* f, int degree, float c[3]) {
+    c[2] = 0;
+    bool ok;
+    if (degree == 2) {
+        float m[3][4];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) m[i][j] = f->su[i + j];
+            m[i][3] = f->sy[i];
         }
+        ok = f->n >= 3 && gaussSolve<3>(m, c);
+    } else {
+        float m[2][3] = {{f->su[0], f->su[1], f->sy[0]}, {f->su[1], f->su[2], f->sy[1]}};
+        ok = f->n >= 2 && gaussSolve<2>(m, c);
     }
-    if (finalSpeedUserSet && yKnown[3] && !xUserSet[3]) {
-        float vfy = yVals[3];
-        float vfx_sq = finalSpeed * finalSpeed - vfy * vfy;
-        if (vfx_sq >= 0) {
-            xVals[3] = sqrtf(vfx_sq);
-            xKnown[3] = true;
+    return ok;
+}
+
+float polyAt(const float c[3], float u) {
+    return c[0] + u * (c[1] + u * c[2]);
+}
+
+bool isRejected(int i) {
+    return fitRejected[i >> 3] & BIT(i & 7);
+}
+
+uint32_t xorshift32(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+float kthSmallest(float* a, int n, int k) {
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        float pivot = a[(lo + hi) / 2];
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (a[i] < pivot) i++;
+            while (a[j] > pivot) j--;
+            if (i <= j) {
+                float tmp = a[i];
+                a[i] = a[j];
+                a[j] = tmp;
+                i++;
+                j--;
+            }
         }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
     }
-    
-    if (xUserSet[6] && !yUserSet[6]) {
-        yVals[6] = xVals[6];
-        yKnown[6] = true;
-    } else if (yUserSet[6] && !xUserSet[6]) {
-        xVals[6] = yVals[6];
-        xKnown[6] = true;
+    return a[k];
+}
+
+// Parabola through three points by divided differences.
+bool parabolaThrough(const float* u, const float* y, int i, int j, int k, float c[3]) {
+    if (u[i] == u[j] || u[j] == u[k] || u[i] == u[k]) return false;
+    float dij = (y[j] - y[i]) / (u[j] - u[i]);
+    float djk = (y[k] - y[j]) / (u[k] - u[j]);
+    c[2] = (djk - dij) / (u[k] - u[i]);
+    c[1] = dij - c[2] * (u[i] + u[j]);
+    c[0] = y[i] - dij * u[i] + c[2] * u[i] * u[j];
+    return true;
+}
+
+// Least-median-of-squares search over ROBUST_ITERS three-point parabolas,
+// scored on at most ROBUST_SAMPLE evenly spaced points of the first n.
+// Returns the best hypothesis and the residual beyond which a point counts
+// as an outlier.
+bool robustParabola(const ListView* lu, const ListView* ly, int n, float uMid, float c[3], float* cutoff) {
+    float u[ROBUST_SAMPLE], y[ROBUST_SAMPLE], r2[ROBUST_SAMPLE];
+    int m = (n < ROBUST_SAMPLE) ? n : ROBUST_SAMPLE;
+    float yMin = 0, yMax = 0;
+    for (int i = 0; i < m; i++) {
+        int idx = (int)((long)i * n / m);
+        u[i] = listAt(lu, idx) - uMid;
+        y[i] = listAt(ly, idx);
+        if (i == 0 || y[i] < yMin) yMin = y[i];
+        if (i == 0 || y[i] > yMax) yMax = y[i];
     }
-    
-    for (int pass = 0; pass < 3; pass++) {
-        trySolve(xVals, xKnown, xUserSet, xEqUsed);
-        
-        if (xKnown[6] && !yKnown[6]) {
-            yVals[6] = xVals[6];
-            yKnown[6] = true;
+
+    uint32_t rng = 0x2545F491;
+    float bestMed = -1;
+    for (int iter = 0; iter < ROBUST_ITERS; iter++) {
+        int i = xorshift32(&rng) % m;
+        int j = xorshift32(&rng) % m;
+        int k = xorshift32(&rng) % m;
+        float h[3];
+        if (!parabolaThrough(u, y, i, j, k, h)) continue;
+        for (int p = 0; p < m; p++) {
+            float r = y[p] - polyAt(h, u[p]);
+            r2[p] = r * r;
         }
-        
-        trySolve(yVals, yKnown, yUserSet, yEqUsed);
-        
-        if (yKnown[6] && !xKnown[6]) {
-            xVals[6] = yVals[6];
-            xKnown[6] = true;
+        float med = kthSmallest(r2, m, m / 2);
+        if (bestMed < 0 || med < bestMed) {
+            bestMed = med;
+            c[0] = h[0]; c[1] = h[1]; c[2] = h[2];
         }
     }
-    
-    if (!speedKnown && xKnown[2] && yKnown[2]) {
-        launchSpeed = sqrtf(xVals[2] * xVals[2] + yVals[2] * yVals[2]);
-        speedKnown = true;
+    if (bestMed < 0) return false;
+
+    float sigma = 1.4826f * (1 + 5.0f / (m > 3 ? m - 3 : 1)) * sqrtf(bestMed);
+    *cutoff = 2.5f * sigma;
+    if (*cutoff < 1e-4f * (yMax - yMin)) *cutoff = 1e-4f * (yMax - yMin);
+    return true;
+}
+
+void drawFitPoints(const ScreenMap* map) {
+    if (labFit.mode == FIT_NONE) return;
+    ListView lx = {}, ly = {};
+    const char* xName = (labFit.mode == FIT_TIME) ? ti_L3 : ti_L1;
+    if (!openList(xName, &lx) || !openList(ti_L2, &ly)) {
+        closeList(&lx);
+        return;
     }
-    if (!angleKnown && xKnown[2] && yKnown[2]) {
-        launchAngle = atan2f(yVals[2], xVals[2]) * RAD_TO_DEG;
-        angleKnown = true;
+    int n = (lx.count < ly.count) ? lx.count : ly.count;
+    gfx_SetColor(0);
+    for (int i = 0; i < n; i++) {
+        int sx = mapX(map, listAt(&lx, i));
+        int sy = mapY(map, listAt(&ly, i));
+        if (labFit.robust && isRejected(i)) {
+            gfx_SetColor(224);
+            gfx_Line(sx - 2, sy - 2, sx + 2, sy + 2);
+            gfx_Line(sx - 2, sy + 2, sx + 2, sy - 2);
+            gfx_SetColor(0);
+        } else {
+            gfx_FillRectangle(sx - 1, sy - 1, 3, 3);
+        }
     }
-    if (!finalSpeedKnown && xKnown[3] && yKnown[3]) {
-        finalSpeed = sqrtf(xVals[3] * xVals[3] + yVals[3] * yVals[3]);
-        finalSpeedKnown = true;
+    closeList(&lx);
+    closeList(&ly);
+}
+
+bool maxHeight(const ProjState<float>& s, float* h, uint8_t* sig = NULL) {
+    if (!(s.yKnown & BIT(2)) || !(s.yKnown & BIT(4))) return false;
+    float v0y = s.yVals[2];
+    float ay = s.yVals[4];
+    float y0 = (s.yKnown & BIT(0)) ? s.yVals[0] : 0;
+    uint8_t y0Sig = (s.yKnown & BIT(0)) ? s.ySig[0] : SIG_EXACT;
+    if (ay < 0 && v0y > 0) {
+        float tMax = -v0y / ay;
+        *h = y0 + v0y * tMax + 0.5f * ay * tMax * tMax;
+        if (sig) *sig = sigSum(*h, y0, y0Sig, *h - y0, sigMin(s.ySig[2], s.ySig[4]));
+    } else {
+        *h = y0;
+        if (sig) *sig = y0Sig;
     }
+    return true;
 }
 
 void drawTable() {
+    const float* xVals = st.xVals;
+    const float* yVals = st.yVals;
+    uint8_t xKnown = st.xKnown;
+    uint8_t yKnown = st.yKnown;
+
     gfx_FillScreen(255);
 
     gfx_SetTextFGColor(0);
     gfx_SetTextScale(1, 1);
     gfx_PrintStringXY("PROJECTILE MOTION - Evan Kolberg", 45, 3);
+    if (sigFigMode) {
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("SF", 300, 3);
+        gfx_SetTextFGColor(0);
+    }
 
     int startX = 5;
     int startY = 16;
@@ -401,27 +457,19 @@ void drawTable() {
             gfx_Rectangle(x, y, colW - 2, rowH - 2);
             
             char valStr[15];
-            float* vals = (col == 0) ? xVals : yVals;
-            bool* known = (col == 0) ? xKnown : yKnown;
-            bool* userSet = (col == 0) ? xUserSet : yUserSet;
+            const float* vals = (col == 0) ? xVals : yVals;
+            const uint8_t* sigs = (col == 0) ? st.xSig : st.ySig;
+            uint8_t known = (col == 0) ? xKnown : yKnown;
+            uint8_t userSet = (col == 0) ? st.xUserSet : st.yUserSet;
             
             if (editing) {
                 gfx_SetTextFGColor(0);
                 char displayStr[15];
-                if (isNegative && inputLen > 0) {
-                    displayStr[0] = '-';
-                    strcpy(displayStr + 1, inputBuf);
-                } else if (isNegative) {
-                    strcpy(displayStr, "-");
-                } else if (inputLen == 0) {
-                    strcpy(displayStr, "_");
-                } else {
-                    strcpy(displayStr, inputBuf);
-                }
+                inputText(displayStr);
                 gfx_PrintStringXY(displayStr, x + 3, y + 3);
-            } else if (known[row]) {
-                floatToStr(vals[row], valStr);
-                gfx_SetTextFGColor(userSet[row] ? 0 : 24);
+            } else if (known & BIT(row)) {
+                valueToStr(vals[row], sigs[row], valStr);
+                gfx_SetTextFGColor((userSet & BIT(row)) ? 0 : 24);
                 gfx_PrintStringXY(valStr, x + 3, y + 3);
             } else {
                 gfx_SetTextFGColor(0);
@@ -437,11 +485,7 @@ void drawTable() {
     
     const char* extraLabels[3] = {"v0:", "ang:", "vf:"};
     const char* extraUnits[3] = {"m/s", "deg", "m/s"};
-    float extraVals[3] = {launchSpeed, launchAngle, finalSpeed};
-    bool extraKnown[3] = {speedKnown, angleKnown, finalSpeedKnown};
-    bool extraUserSet[3] = {speedUserSet, angleUserSet, finalSpeedUserSet};
-    
-    for (int i = 0; i < 3; i++) {
+    for (int i = 0; i < EXTRA_COUNT; i++) {
         int y = extraStartY + i * extraRowH;
         
         gfx_SetTextFGColor(0);
@@ -464,21 +508,12 @@ void drawTable() {
         if (editing) {
             gfx_SetTextFGColor(0);
             char displayStr[15];
-            if (isNegative && inputLen > 0) {
-                displayStr[0] = '-';
-                strcpy(displayStr + 1, inputBuf);
-            } else if (isNegative) {
-                strcpy(displayStr, "-");
-            } else if (inputLen == 0) {
-                strcpy(displayStr, "_");
-            } else {
-                strcpy(displayStr, inputBuf);
-            }
+            inputText(displayStr);
             gfx_PrintStringXY(displayStr, boxX + 3, y + 3);
-        } else if (extraKnown[i]) {
+        } else if (st.extraKnown & BIT(i)) {
             char valStr[15];
-            floatToStr(extraVals[i], valStr);
-            gfx_SetTextFGColor(extraUserSet[i] ? 0 : 24);
+            valueToStr(st.extraVals[i], st.extraSig[i], valStr);
+            gfx_SetTextFGColor((st.extraUserSet & BIT(i)) ? 0 : 24);
             gfx_PrintStringXY(valStr, boxX + 3, y + 3);
         } else {
             gfx_SetTextFGColor(0);
@@ -493,32 +528,24 @@ void drawTable() {
 
     int mhY = extraStartY + 3 * extraRowH;
     gfx_PrintStringXY("Max Height:", rightColX, mhY + 3);
-    if (yKnown[2] && yKnown[4]) {
-        float v0y = yVals[2];
-        float ay = yVals[4];
-        float y0 = yKnown[0] ? yVals[0] : 0;
-        float maxH;
-        if (ay < 0 && v0y > 0) {
-            float tMax = -v0y / ay;
-            maxH = y0 + v0y * tMax + 0.5f * ay * tMax * tMax;
-        } else {
-            maxH = y0;
-        }
+    float maxH;
+    uint8_t maxHSig;
+    if (maxHeight(st, &maxH, &maxHSig)) {
         char buf[20];
-        floatToStr(maxH, buf);
+        int len = valueToStr(maxH, maxHSig, buf);
         gfx_PrintStringXY(buf, rightColX + 80, mhY + 3);
-        gfx_PrintStringXY("m", rightColX + 80 + strlen(buf) * 8, mhY + 3);
+        gfx_PrintStringXY("m", rightColX + 80 + len * 8, mhY + 3);
     } else {
         gfx_PrintStringXY("?", rightColX + 90, mhY + 3);
     }
 
     int toaY = extraStartY + 4 * extraRowH;
     gfx_PrintStringXY("Time in Air:", rightColX, toaY + 3);
-    if (xKnown[6]) {
+    if (xKnown & BIT(6)) {
         char buf[20];
-        floatToStr(xVals[6], buf);
+        int len = valueToStr(xVals[6], st.xSig[6], buf);
         gfx_PrintStringXY(buf, rightColX + 80, toaY + 3);
-        gfx_PrintStringXY("s", rightColX + 80 + strlen(buf) * 8, toaY + 3);
+        gfx_PrintStringXY("s", rightColX + 80 + len * 8, toaY + 3);
     } else {
         gfx_PrintStringXY("?", rightColX + 90, toaY + 3);
     }
@@ -552,22 +579,7 @@ void drawTable() {
         gfx_PrintStringXY("Equations used:", 5, eqY);
         eqY += 10;
     }
-    char* tok = allEqs;
-    while (*tok && eqY < 220) {
-        char* end = strchr(tok, '|');
-        char eq[64];
-        if (end) {
-            int len = end - tok;
-            strncpy(eq, tok, len);
-            eq[len] = '\0';
-            tok = end + 1;
-        } else {
-            strcpy(eq, tok);
-            tok += strlen(tok);
-        }
-        gfx_PrintStringXY(eq, 5, eqY);
-        eqY += 10;
-    }
+    printEqList(allEqs, eqY, 220);
 
     int miniX = 168;
     int miniY = 105;
@@ -577,60 +589,28 @@ void drawTable() {
     gfx_SetColor(200);
     gfx_Rectangle(miniX, miniY, miniW, miniH);
 
-    if (xKnown[2] && yKnown[2] && xKnown[6] && xVals[6] > 0) {
+    if ((xKnown & BIT(2)) && (yKnown & BIT(2)) && (xKnown & BIT(6)) && xVals[6] > 0) {
         float totalTime = xVals[6];
-        float x0 = xKnown[0] ? xVals[0] : 0;
-        float y0 = yKnown[0] ? yVals[0] : 0;
-        float maxPx = x0, minPx = x0, maxPy = y0, minPy = y0;
-        for (int i = 0; i <= 20; i++) {
-            float tt = (i / 20.0f) * totalTime;
-            float px = x0 + xVals[2] * tt + 0.5f * xVals[4] * tt * tt;
-            float py = y0 + yVals[2] * tt + 0.5f * yVals[4] * tt * tt;
-            if (px > maxPx) maxPx = px;
-            if (px < minPx) minPx = px;
-            if (py > maxPy) maxPy = py;
-            if (py < minPy) minPy = py;
-        }
-        float rangeX = maxPx - minPx;
-        float rangeY = maxPy - minPy;
-        if (rangeX < 0.1f) rangeX = 0.1f;
-        if (rangeY < 0.1f) rangeY = 0.1f;
-        minPx -= rangeX * 0.1f; maxPx += rangeX * 0.1f;
-        minPy -= rangeY * 0.1f; maxPy += rangeY * 0.1f;
-        rangeX = maxPx - minPx;
-        rangeY = maxPy - minPy;
-
-        float scaleX = rangeX / (miniW - 10);
-        float scaleY = rangeY / (miniH - 10);
-        if (scaleX > scaleY) {
-            float newRangeY = scaleX * (miniH - 10);
-            float centerY = (minPy + maxPy) / 2;
-            minPy = centerY - newRangeY / 2;
-            maxPy = centerY + newRangeY / 2;
-            rangeY = newRangeY;
-        } else {
-            float newRangeX = scaleY * (miniW - 10);
-            float centerX = (minPx + maxPx) / 2;
-            minPx = centerX - newRangeX / 2;
-            maxPx = centerX + newRangeX / 2;
-            rangeX = newRangeX;
-        }
+        float x0 = (xKnown & BIT(0)) ? xVals[0] : 0;
+        float y0 = (yKnown & BIT(0)) ? yVals[0] : 0;
+        float minPx, maxPx, minPy, maxPy;
+        trajExtent(x0, xVals[2], xVals[4], totalTime, &minPx, &maxPx);
+        trajExtent(y0, yVals[2], yVals[4], totalTime, &minPy, &maxPy);
+        ScreenMap map;
+        fitViewport(&map, minPx, maxPx, minPy, maxPy, miniX + 5, miniY + miniH - 5, miniW - 10, miniH - 10);
 
+        TrajPlot plot;
+        initTrajPlot(&plot, &map, x0, xVals[2], xVals[4], y0, yVals[2], yVals[4], totalTime / 50);
         gfx_SetColor(24);
-        int lastSx = -1, lastSy = -1;
-        for (int i = 0; i <= 50; i++) {
-            float tt = (i / 50.0f) * totalTime;
-            float px = x0 + xVals[2] * tt + 0.5f * xVals[4] * tt * tt;
-            float py = y0 + yVals[2] * tt + 0.5f * yVals[4] * tt * tt;
-            int sx = miniX + 5 + (int)(((px - minPx) / rangeX) * (miniW - 10));
-            int sy = miniY + miniH - 5 - (int)(((py - minPy) / rangeY) * (miniH - 10));
-            if (lastSx >= 0) gfx_Line(lastSx, lastSy, sx, sy);
+        int lastSx = trajX(&plot, 0), lastSy = trajY(&plot, 0);
+        for (int i = 1; i <= 50; i++) {
+            int sx = trajX(&plot, i);
+            int sy = trajY(&plot, i);
+            gfx_Line(lastSx, lastSy, sx, sy);
             lastSx = sx; lastSy = sy;
         }
         gfx_SetColor(224);
-        int startSx = miniX + 5 + (int)(((x0 - minPx) / rangeX) * (miniW - 10));
-        int startSy = miniY + miniH - 5 - (int)(((y0 - minPy) / rangeY) * (miniH - 10));
-        gfx_FillCircle(startSx, startSy, 3);
+        gfx_FillCircle(trajX(&plot, 0), trajY(&plot, 0), 3);
     }
 
     gfx_SetTextFGColor(160);
@@ -639,6 +619,29 @@ void drawTable() {
     gfx_PrintStringXY("[graph]", 265, 230);
 }
 
+const char* legendLines[] = {
+    "p0: initial position (meters)",
+    "pf: final position (meters)",
+    "v0: initial velocity (meters/sec)",
+    "vf: final velocity (meters/sec)",
+    "a: acceleration (meters/sec^2)",
+    "d: displacement (meters)",
+    "ang: launch angle (degrees)",
+    "t: time (seconds)",
+    "mode/quit button: reset all cells",
+    "del/ins button: clear cell",
+    "clear button: cancel / quit program",
+    "graph button: enlarge graph",
+    "window button: angle sweep / fan",
+    "stat button: fit lab data in L1-L3",
+    "y= button: scenario sheet for the cell",
+    "math button: sig fig display on/off",
+    "prgm button: practice problem",
+#ifdef VERIFY64
+    "vars button: 64-bit digit check",
+#endif
+};
+
 void drawLegend() {
     gfx_FillScreen(255);
     gfx_SetTextFGColor(0);
@@ -646,18 +649,10 @@ void drawLegend() {
 
     gfx_PrintStringXY("Legend", 137, 5);
 
-    gfx_PrintStringXY("p0: initial position (meters)", 40, 30);
-    gfx_PrintStringXY("pf: final position (meters)", 40, 45);
-    gfx_PrintStringXY("v0: initial velocity (meters/sec)", 40, 60);
-    gfx_PrintStringXY("vf: final velocity (meters/sec)", 40, 75);
-    gfx_PrintStringXY("a: acceleration (meters/sec^2)", 40, 90);
-    gfx_PrintStringXY("d: displacement (meters)", 40, 105);
-    gfx_PrintStringXY("ang: launch angle (degrees)", 40, 120);
-    gfx_PrintStringXY("t: time (seconds)", 40, 135);
-    gfx_PrintStringXY("mode/quit button: reset all cells", 40, 150);
-    gfx_PrintStringXY("del/ins button: clear cell", 40, 165);
-    gfx_PrintStringXY("clear button: cancel / quit program", 40, 180);
-    gfx_PrintStringXY("graph button: enlarge graph", 40, 195);
+    int lineCount = sizeof(legendLines) / sizeof(legendLines[0]);
+    for (int i = 0; i < lineCount; i++) {
+        gfx_PrintStringXY(legendLines[i], 40, 20 + i * 11);
+    }
 
     gfx_SetTextFGColor(24);
     gfx_PrintStringXY("Any key to return", 101, 225);
@@ -669,7 +664,9 @@ void drawLegend() {
 }
 
 void drawGraph() {
-    if (!xKnown[2] || !yKnown[2] || !xKnown[6]) return;
+    const float* xVals = st.xVals;
+    const float* yVals = st.yVals;
+    if (!(st.xKnown & BIT(2)) || !(st.yKnown & BIT(2)) || !(st.xKnown & BIT(6))) return;
     
     gfx_FillScreen(255);
     gfx_SetColor(0);
@@ -677,61 +674,33 @@ void drawGraph() {
     float totalTime = xVals[6];
     if (totalTime <= 0) totalTime = 5.0f;
     
-    float x0 = xKnown[0] ? xVals[0] : 0;
-    float y0 = yKnown[0] ? yVals[0] : 0;
-    float maxX = x0, minX = x0, maxY = y0, minY = y0;
-    
-    for (int i = 0; i <= 50; i++) {
-        float t = (i / 50.0f) * totalTime;
-        float px = x0 + xVals[2] * t + 0.5f * xVals[4] * t * t;
-        float py = y0 + yVals[2] * t + 0.5f * yVals[4] * t * t;
-        if (px > maxX) maxX = px;
-        if (px < minX) minX = px;
-        if (py > maxY) maxY = py;
-        if (py < minY) minY = py;
-    }
-    
-    float rangeX = maxX - minX;
-    float rangeY = maxY - minY;
-    if (rangeX < 0.1f) rangeX = 0.1f;
-    if (rangeY < 0.1f) rangeY = 0.1f;
-
-    float margin = 0.1f;
-    minX -= rangeX * margin;
-    maxX += rangeX * margin;
-    minY -= rangeY * margin;
-    maxY += rangeY * margin;
-    rangeX = maxX - minX;
-    rangeY = maxY - minY;
+    float x0 = (st.xKnown & BIT(0)) ? xVals[0] : 0;
+    float y0 = (st.yKnown & BIT(0)) ? yVals[0] : 0;
+    float minX, maxX, minY, maxY;
+    trajExtent(x0, xVals[2], xVals[4], totalTime, &minX, &maxX);
+    trajExtent(y0, yVals[2], yVals[4], totalTime, &minY, &maxY);
 
     int graphX = 30;
     int graphY = 15;
     int graphW = 280;
     int graphH = 190;
 
-    float scaleX = rangeX / graphW;
-    float scaleY = rangeY / graphH;
-
-    if (scaleX > scaleY) {
-        float newRangeY = scaleX * graphH;
-        float centerY = (minY + maxY) / 2;
-        minY = centerY - newRangeY / 2;
-        maxY = centerY + newRangeY / 2;
-        rangeY = newRangeY;
-    } else {
-        float newRangeX = scaleY * graphW;
-        float centerX = (minX + maxX) / 2;
-        minX = centerX - newRangeX / 2;
-        maxX = centerX + newRangeX / 2;
-        rangeX = newRangeX;
+    if (labFit.mode != FIT_NONE && labFit.hasX) {
+        if (labFit.minX < minX) minX = labFit.minX;
+        if (labFit.maxX > maxX) maxX = labFit.maxX;
+        if (labFit.minY < minY) minY = labFit.minY;
+        if (labFit.maxY > maxY) maxY = labFit.maxY;
     }
 
+    ScreenMap map;
+    fitViewport(&map, minX, maxX, minY, maxY, graphX, graphY + graphH, graphW, graphH);
+
     gfx_SetColor(200);
     gfx_Rectangle(graphX, graphY, graphW, graphH);
     
     gfx_SetColor(0);
-    int zeroX = graphX + (int)((-minX / rangeX) * graphW);
-    int zeroY = graphY + graphH - (int)((-minY / rangeY) * graphH);
+    int zeroX = mapX(&map, 0);
+    int zeroY = mapY(&map, 0);
     
     if (zeroX >= graphX && zeroX <= graphX + graphW) {
         gfx_VertLine(zeroX, graphY, graphH);
@@ -746,14 +715,12 @@ void drawGraph() {
     
     gfx_SetColor(24);
     
+    TrajPlot plot;
+    initTrajPlot(&plot, &map, x0, xVals[2], xVals[4], y0, yVals[2], yVals[4], totalTime / 100);
     int lastSx = -1, lastSy = -1;
     for (int i = 0; i <= 100; i++) {
-        float t = (i / 100.0f) * totalTime;
-        float px = x0 + xVals[2] * t + 0.5f * xVals[4] * t * t;
-        float py = y0 + yVals[2] * t + 0.5f * yVals[4] * t * t;
-        
-        int sx = graphX + (int)(((px - minX) / rangeX) * graphW);
-        int sy = graphY + graphH - (int)(((py - minY) / rangeY) * graphH);
+        int sx = trajX(&plot, i);
+        int sy = trajY(&plot, i);
         
         if (sx >= graphX && sx <= graphX + graphW && sy >= graphY && sy <= graphY + graphH) {
             if (lastSx >= 0) {
@@ -765,9 +732,9 @@ void drawGraph() {
     }
     
     gfx_SetColor(224);
-    int startSx = graphX + (int)(((x0 - minX) / rangeX) * graphW);
-    int startSy = graphY + graphH - (int)(((y0 - minY) / rangeY) * graphH);
-    gfx_FillCircle(startSx, startSy, 4);
+    gfx_FillCircle(trajX(&plot, 0), trajY(&plot, 0), 4);
+
+    if (labFit.hasX) drawFitPoints(&map);
     
     gfx_SetTextFGColor(0);
     gfx_PrintStringXY("Any key to return", 101, 225);
@@ -778,102 +745,968 @@ void drawGraph() {
     while (kb_AnyKey()) kb_Scan();
 }
 
-void startInput() {
-    inputMode = true;
-    inputLen = 0;
-    inputBuf[0] = '\0';
-    hasDecimal = false;
-    isNegative = false;
+void setCell(ProjState<float>& s, int row, int col, bool set, float val, uint8_t sig = SIG_EXACT) {
+    float* vals = s.extraVals;
+    uint8_t* sigs = s.extraSig;
+    uint8_t* known = &s.extraKnown;
+    uint8_t* userSet = &s.extraUserSet;
+    int i = row - ROWS;
+    if (row < ROWS) {
+        vals = (col == 0) ? s.xVals : s.yVals;
+        sigs = (col == 0) ? s.xSig : s.ySig;
+        known = (col == 0) ? &s.xKnown : &s.yKnown;
+        userSet = (col == 0) ? &s.xUserSet : &s.yUserSet;
+        i = row;
+    }
+    vals[i] = set ? val : 0;
+    sigs[i] = set ? sig : SIG_EXACT;
+    if (set) {
+        *known |= BIT(i);
+        *userSet |= BIT(i);
+    } else {
+        *known &= ~BIT(i);
+        *userSet &= ~BIT(i);
+    }
+}
+
+bool getCell(const ProjState<float>& s, int row, int col, float* val) {
+    if (row >= ROWS) {
+        *val = s.extraVals[row - ROWS];
+        return s.extraKnown & BIT(row - ROWS);
+    }
+    *val = (col == 0) ? s.xVals[row] : s.yVals[row];
+    return ((col == 0) ? s.xKnown : s.yKnown) & BIT(row);
+}
+
+#ifdef VERIFY64
+int printDiffDigits(const char* ref, const char* val, int x, int y) {
+    int agree = 0;
+    bool same = true;
+    gfx_SetTextXY(x, y);
+    for (int i = 0; val[i]; i++) {
+        if (same && ref[i] != val[i]) same = false;
+        if (same && val[i] >= '0' && val[i] <= '9') agree++;
+        gfx_SetTextFGColor(same ? 0 : 224);
+        gfx_PrintChar(val[i]);
+    }
+    return agree;
+}
+
+void drawVerifyRow(const char* label, bool hasLo, float lo, bool hasHi, long double hi, int y) {
+    char loStr[20], hiStr[20];
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY(label, 5, y);
+    if (!hasLo || !hasHi) {
+        gfx_PrintStringXY(hasLo ? "no 64-bit solution" : "no float solution", 50, y);
+        return;
+    }
+    formatReal<long double, unsigned long long>(lo, loStr, 10, 12);
+    formatReal<long double, unsigned long long>(hi, hiStr, 10, 12);
+    gfx_SetTextXY(50, y);
+    gfx_PrintString(loStr);
+    int agree = printDiffDigits(loStr, hiStr, 150, y);
+    gfx_SetTextFGColor(24);
+    gfx_SetTextXY(270, y);
+    if (strcmp(loStr, hiStr) == 0) gfx_PrintString("all");
+    else gfx_PrintInt(agree, 1);
+}
+
+// Re-solves the user's inputs in 64-bit long double and lists every derived
+// value next to its float result, with the 64-bit digits that differ in red.
+void drawVerify() {
+    ProjState<long double> hi;
+    memset(&hi, 0, sizeof(hi));
+    for (int i = 0; i < VAR_COUNT; i++) {
+        hi.xVals[i] = st.xVals[i];
+        hi.yVals[i] = st.yVals[i];
+    }
+    for (int i = 0; i < EXTRA_COUNT; i++) hi.extraVals[i] = st.extraVals[i];
+    hi.xKnown = hi.xUserSet = st.xUserSet;
+    hi.yKnown = hi.yUserSet = st.yUserSet;
+    hi.extraKnown = hi.extraUserSet = st.extraUserSet;
+    autoSolve(hi, NULL, NULL);
+
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("64-bit check", 112, 3);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("float", 50, 16);
+    gfx_PrintStringXY("64-bit", 150, 16);
+    gfx_PrintStringXY("ok", 270, 16);
+
+    int y = 30;
+    for (int col = 0; col < COLS; col++) {
+        const float* vals = (col == 0) ? st.xVals : st.yVals;
+        const long double* hiVals = (col == 0) ? hi.xVals : hi.yVals;
+        uint8_t known = (col == 0) ? st.xKnown : st.yKnown;
+        uint8_t hiKnown = (col == 0) ? hi.xKnown : hi.yKnown;
+        uint8_t userSet = (col == 0) ? st.xUserSet : st.yUserSet;
+        for (int i = 0; i < VAR_COUNT; i++) {
+            if (userSet & BIT(i)) continue;
+            if (!((known | hiKnown) & BIT(i))) continue;
+            char label[6] = {col == 0 ? 'x' : 'y', ' '};
+            strcpy(label + 2, rowLabels[i]);
+            drawVerifyRow(label, known & BIT(i), vals[i], hiKnown & BIT(i), hiVals[i], y);
+            y += 11;
+        }
+    }
+    for (int i = 0; i < EXTRA_COUNT; i++) {
+        if (st.extraUserSet & BIT(i)) continue;
+        if (!((st.extraKnown | hi.extraKnown) & BIT(i))) continue;
+        drawVerifyRow(extraShortLabels[i], st.extraKnown & BIT(i), st.extraVals[i],
+                      hi.extraKnown & BIT(i), hi.extraVals[i], y);
+        y += 11;
+    }
+    if (y == 30) {
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("Nothing solved yet", 88, 100);
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("Any key to return", 101, 225);
+
+    gfx_BlitBuffer();
+
+    while (!kb_AnyKey()) kb_Scan();
+    while (kb_AnyKey()) kb_Scan();
+}
+#endif
+
+#define SWEEP_STEP 5
+#define SWEEP_ROWS (90 / SWEEP_STEP + 1)
+#define FAN_STEP 15
+
+struct SweepRow {
+    float range, time, maxH;
+    bool lands;
+};
+
+struct SweepLaunch {
+    float speed, x0, y0, yLand, ax, ay;
+};
+
+bool getSweepLaunch(SweepLaunch* l) {
+    if (!(st.extraKnown & BIT(EX_SPEED)) || !(st.yKnown & BIT(4)) || !(st.xKnown & BIT(4))) return false;
+    l->speed = st.extraVals[EX_SPEED];
+    l->x0 = (st.xKnown & BIT(0)) ? st.xVals[0] : 0;
+    l->y0 = (st.yKnown & BIT(0)) ? st.yVals[0] : 0;
+    l->yLand = (st.yKnown & BIT(1)) ? st.yVals[1] : l->y0;
+    l->ax = st.xVals[4];
+    l->ay = st.yVals[4];
+    return true;
+}
+
+void sweepAngle(const SweepLaunch* l, int deg, SweepRow* r) {
+    float vx = l->speed * cosDeg(deg);
+    float vy = l->speed * sinDeg(deg);
+    float t1, t2;
+    r->lands = l->ay != 0 && solveQuadratic(0.5f * l->ay, vy, l->y0 - l->yLand, &t1, &t2) && pickTime(t1, t2, &r->time);
+    if (r->lands) r->range = vx * r->time + 0.5f * l->ax * r->time * r->time;
+    r->maxH = (vy > 0 && l->ay < 0) ? l->y0 - 0.5f * vy * vy / l->ay : l->y0;
+}
+
+void drawFan(const SweepLaunch* l) {
+    int graphX = 30;
+    int graphY = 15;
+    int graphW = 280;
+    int graphH = 190;
+
+    float minX = l->x0, maxX = l->x0, minY = l->y0, maxY = l->y0;
+    for (int deg = FAN_STEP; deg < 90; deg += FAN_STEP) {
+        SweepRow r;
+        sweepAngle(l, deg, &r);
+        if (!r.lands) continue;
+        float lo, hi;
+        trajExtent(l->x0, l->speed * cosDeg(deg), l->ax, r.time, &lo, &hi);
+        if (lo < minX) minX = lo;
+        if (hi > maxX) maxX = hi;
+        if (r.maxH > maxY) maxY = r.maxH;
+        if (l->yLand < minY) minY = l->yLand;
+    }
+
+    ScreenMap map;
+    fitViewport(&map, minX, maxX, minY, maxY, graphX, graphY + graphH, graphW, graphH);
+
+    gfx_FillScreen(255);
+    gfx_SetColor(200);
+    gfx_Rectangle(graphX, graphY, graphW, graphH);
+    int zeroY = mapY(&map, l->yLand);
+    if (zeroY >= graphY && zeroY <= graphY + graphH) {
+        gfx_SetColor(0);
+        gfx_HorizLine(graphX, zeroY, graphW);
+    }
+
+    const uint8_t fanColors[] = {24, 7, 224, 227, 96};
+    for (int deg = FAN_STEP, k = 0; deg < 90; deg += FAN_STEP, k++) {
+        SweepRow r;
+        sweepAngle(l, deg, &r);
+        if (!r.lands) continue;
+        TrajPlot plot;
+        initTrajPlot(&plot, &map, l->x0, l->speed * cosDeg(deg), l->ax,
+                     l->y0, l->speed * sinDeg(deg), l->ay, r.time / 40);
+        gfx_SetColor(fanColors[k % 5]);
+        for (int i = 1; i <= 40; i++) {
+            gfx_Line(trajX(&plot, i - 1), trajY(&plot, i - 1), trajX(&plot, i), trajY(&plot, i));
+        }
+        char label[4];
+        gfx_SetTextFGColor(fanColors[k % 5]);
+        label[0] = '0' + deg / 10;
+        label[1] = '0' + deg % 10;
+        label[2] = '\0';
+        gfx_PrintStringXY(label, graphX + 5 + k * 24, graphY + 5);
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("Any key to return", 101, 225);
+    gfx_BlitBuffer();
+
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+// Range, flight time and apex for every SWEEP_STEP degrees at the current
+// launch speed, from the whole-degree trig table.
+void drawSweep() {
+    SweepLaunch l;
+    bool ok = getSweepLaunch(&l);
+
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("Angle sweep", 116, 3);
+
+    if (!ok) {
+        gfx_PrintStringXY("Enter the launch speed first", 48, 100);
+    } else {
+        SweepRow rows[SWEEP_ROWS];
+        int best = -1;
+        for (int i = 0; i < SWEEP_ROWS; i++) {
+            sweepAngle(&l, i * SWEEP_STEP, &rows[i]);
+            if (rows[i].lands && (best < 0 || rows[i].range > rows[best].range)) best = i;
+        }
+
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("ang", 10, 16);
+        gfx_PrintStringXY("range", 60, 16);
+        gfx_PrintStringXY("time", 150, 16);
+        gfx_PrintStringXY("max h", 240, 16);
+
+        for (int i = 0; i < SWEEP_ROWS; i++) {
+            int y = 27 + i * 10;
+            char buf[15];
+            if (i == best) {
+                gfx_SetColor(183);
+                gfx_FillRectangle(5, y - 1, 310, 10);
+            }
+            gfx_SetTextFGColor(0);
+            gfx_SetTextXY(10, y);
+            gfx_PrintInt(i * SWEEP_STEP, 1);
+            if (rows[i].lands) {
+                floatToStr(rows[i].range, buf);
+                gfx_PrintStringXY(buf, 60, y);
+                floatToStr(rows[i].time, buf);
+                gfx_PrintStringXY(buf, 150, y);
+            } else {
+                gfx_PrintStringXY("-", 60, y);
+                gfx_PrintStringXY("-", 150, y);
+            }
+            floatToStr(rows[i].maxH, buf);
+            gfx_PrintStringXY(buf, 240, y);
+        }
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("graph: angle fan", 5, 225);
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("Any key to return", 180, 225);
+    gfx_BlitBuffer();
+
+    while (!kb_AnyKey()) kb_Scan();
+    bool fan = ok && (kb_Data[1] & kb_Graph);
+    waitKeyRelease();
+    if (fan) drawFan(&l);
+}
+
+// Fits the lab lists. FIT_TIME: L1 = t, L2 = y and optionally L3 = x, giving
+// y0, v0y and a directly. FIT_SHAPE: L1 = x, L2 = y; the path's curvature and
+// the current y acceleration give v0x.
+bool fitLists(ListView& l1, ListView& l2, ListView& l3, uint8_t mode, bool robust, LabFit* out, const char** err) {
+    if (!openList(ti_L1, &l1) || !openList(ti_L2, &l2)) {
+        *err = "L1 and L2 must exist";
+        return false;
+    }
+    int n = l1.count;
+    if (l2.count != n) {
+        *err = "L1 and L2 differ in length";
+        return false;
+    }
+    if (n < 3) {
+        *err = "Need at least 3 points";
+        return false;
+    }
+    if (n > FIT_MAX_POINTS) n = FIT_MAX_POINTS;
+    bool hasX = (mode == FIT_SHAPE) || (openList(ti_L3, &l3) && l3.count == l1.count);
+
+    float uFirst = listAt(&l1, 0);
+    float uLast = listAt(&l1, n - 1);
+    float uMid = 0.5f * (uFirst + uLast);
+
+    float hyp[3], cutoff = 0;
+    memset(fitRejected, 0, sizeof(fitRejected));
+    if (robust && !robustParabola(&l1, &l2, n, uMid, hyp, &cutoff)) {
+        *err = "Points are degenerate";
+        return false;
+    }
+
+    QuadFit fy, fx;
+    memset(&fy, 0, sizeof(fy));
+    memset(&fx, 0, sizeof(fx));
+    out->rejected = 0;
+    out->minY = out->maxY = listAt(&l2, 0);
+    out->minX = out->maxX = (mode == FIT_SHAPE) ? uFirst : 0;
+    for (int i = 0; i < n; i++) {
+        float u = listAt(&l1, i) - uMid;
+        float y = listAt(&l2, i);
+        bool keep = !robust || fabsf(y - polyAt(hyp, u)) <= cutoff;
+        if (keep) fitAdd(&fy, u, y);
+        else {
+            fitRejected[i >> 3] |= BIT(i & 7);
+            out->rejected++;
+        }
+        if (y < out->minY) out->minY = y;
+        if (y > out->maxY) out->maxY = y;
+        float x = (mode == FIT_SHAPE) ? u + uMid : 0;
+        if (mode == FIT_TIME && hasX) {
+            x = listAt(&l3, i);
+            if (keep) fitAdd(&fx, u, x);
+            if (i == 0) out->minX = out->maxX = x;
+        }
+        if (x < out->minX) out->minX = x;
+        if (x > out->maxX) out->maxX = x;
+    }
+
+    float cy[3], cx[3];
+    if (!fitSolve(&fy, 2, cy) || (mode == FIT_TIME && hasX && !fitSolve(&fx, 1, cx))) {
+        *err = "Points are degenerate";
+        return false;
+    }
+
+    float sse = 0;
+    for (int i = 0; i < n; i++) {
+        if (isRejected(i)) continue;
+        float u = listAt(&l1, i) - uMid;
+        float r = listAt(&l2, i) - polyAt(cy, u);
+        sse += r * r;
+        if (mode == FIT_TIME && hasX) {
+            r = listAt(&l3, i) - polyAt(cx, u);
+            sse += r * r;
+        }
+    }
+    out->rms = sqrtf(sse / fy.n);
+
+    float u0 = uFirst - uMid;
+    float slope = cy[1] + 2 * cy[2] * u0;
+    out->p0y = polyAt(cy, u0);
+    if (mode == FIT_TIME) {
+        out->v0y = slope;
+        out->ay = 2 * cy[2];
+        out->span = uLast - uFirst;
+        out->p0x = hasX ? polyAt(cx, u0) : 0;
+        out->v0x = hasX ? cx[1] : 0;
+    } else {
+        out->ay = st.yVals[4];
+        float vx2 = (cy[2] == 0) ? 0 : out->ay / (2 * cy[2]);
+        if (vx2 <= 0) {
+            *err = "Curvature doesn't match a";
+            return false;
+        }
+        out->v0x = sqrtf(vx2);
+        if (uLast < uFirst) out->v0x = -out->v0x;
+        out->v0y = slope * out->v0x;
+        out->p0x = uFirst;
+        out->span = (uLast - uFirst) / out->v0x;
+    }
+    out->mode = mode;
+    out->hasX = hasX;
+    out->robust = robust;
+    out->n = n;
+    return true;
+}
+
+// fitLists can fail with any of the lists open; they are all closed here.
+bool runLabFit(uint8_t mode, bool robust, LabFit* out, const char** err) {
+    ListView l1 = {}, l2 = {}, l3 = {};
+    bool ok = fitLists(l1, l2, l3, mode, robust, out, err);
+    closeList(&l1);
+    closeList(&l2);
+    closeList(&l3);
+    return ok;
+}
+
+void applyLabFit(const LabFit* f) {
+    initData();
+    labFit = *f;
+    setCell(st, 0, 1, true, f->p0y);
+    setCell(st, 2, 1, true, f->v0y);
+    setCell(st, 4, 1, true, f->ay);
+    setCell(st, 6, f->hasX ? 0 : 1, true, f->span);
+    if (f->hasX) {
+        setCell(st, 0, 0, true, f->p0x);
+        setCell(st, 2, 0, true, f->v0x);
+    }
+    autoSolve();
+}
+
+void drawFitValue(const char* label, float val, int y) {
+    char buf[15];
+    gfx_PrintStringXY(label, 20, y);
+    floatToStr(val, buf);
+    gfx_PrintStringXY(buf, 140, y);
+}
+
+void drawLabFit() {
+    LabFit f;
+    const char* err = NULL;
+    bool haveFit = false;
+    bool robust = false;
+    uint8_t lastMode = FIT_NONE;
+
+    while (true) {
+        gfx_FillScreen(255);
+        gfx_SetTextFGColor(0);
+        gfx_SetTextScale(1, 1);
+        gfx_PrintStringXY("Lab data fit", 112, 3);
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("1: L1=t  L2=y  (L3=x)", 20, 20);
+        gfx_PrintStringXY("2: L1=x  L2=y  (uses a of y)", 20, 32);
+        gfx_PrintStringXY(robust ? "3: outlier rejection: on" : "3: outlier rejection: off", 20, 44);
+
+        gfx_SetTextFGColor(0);
+        if (err) {
+            gfx_SetTextFGColor(224);
+            gfx_PrintStringXY(err, 20, 60);
+        } else if (haveFit) {
+            gfx_SetTextXY(20, 58);
+            gfx_PrintString("points: ");
+            gfx_PrintInt(f.n, 1);
+            if (f.robust) {
+                gfx_PrintString("  rejected: ");
+                gfx_PrintInt(f.rejected, 1);
+            }
+            drawFitValue("x0 (m)", f.p0x, 70);
+            drawFitValue("y0 (m)", f.p0y, 82);
+            if (f.hasX) drawFitValue("v0x (m/s)", f.v0x, 94);
+            drawFitValue("v0y (m/s)", f.v0y, 106);
+            drawFitValue("a (m/s^2)", f.ay, 118);
+            drawFitValue("span (s)", f.span, 130);
+            drawFitValue("rms resid (m)", f.rms, 142);
+            gfx_SetTextFGColor(24);
+            gfx_PrintStringXY("enter: use fit   graph: use + plot", 20, 170);
+        }
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("clear: return", 115, 225);
+        gfx_BlitBuffer();
+
+        while (!kb_AnyKey()) kb_Scan();
+        bool key1 = kb_Data[3] & kb_1;
+        bool key2 = kb_Data[4] & kb_2;
+        bool key3 = kb_Data[5] & kb_3;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool clear = kb_Data[6] & kb_Clear;
+        waitKeyRelease();
+
+        if (key3) {
+            robust = !robust;
+            if (lastMode == FIT_NONE) continue;
+        }
+        if (key1 || key2 || key3) {
+            if (!key3) lastMode = key1 ? FIT_TIME : FIT_SHAPE;
+            err = NULL;
+            haveFit = runLabFit(lastMode, robust, &f, &err);
+        } else if (haveFit && (enter || graph)) {
+            applyLabFit(&f);
+            if (graph) drawGraph();
+            return;
+        } else if (clear) {
+            return;
+        }
+    }
 }
 
 void finishInput() {
     if (inputLen > 0 || isNegative) {
-        char fullStr[15];
-        if (isNegative) {
-            fullStr[0] = '-';
-            strcpy(fullStr + 1, inputBuf);
+        setCell(st, curRow, curCol, true, parseInput(), countSigFigs(inputBuf));
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(st, curRow, curCol, false, 0);
+    autoSolve();
+}
+
+#define SHEET_MAX 50
+#define SHEET_VISIBLE 15
+
+// Scenario rows for the sheet view. Each row is a full packed state that is
+// re-solved only when its parameter is edited.
+ProjState<float> sheetRows[SHEET_MAX];
+int sheetCount = 0;
+int sheetParamRow = -1;
+int sheetParamCol = 0;
+
+void cellLabel(int row, int col, char* out) {
+    if (row >= ROWS) {
+        strcpy(out, extraShortLabels[row - ROWS]);
+        return;
+    }
+    out[0] = (col == 0) ? 'x' : 'y';
+    out[1] = ' ';
+    strcpy(out + 2, rowLabels[row]);
+}
+
+void drawSheetValue(bool known, float val, uint8_t sig, int x, int y) {
+    char buf[15];
+    if (known) valueToStr(val, sig, buf);
+    else strcpy(buf, "?");
+    gfx_PrintStringXY(buf, x, y);
+}
+
+void drawSheet(int sel, int top) {
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("Scenarios", 124, 3);
+
+    char label[8];
+    cellLabel(sheetParamRow, sheetParamCol, label);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY(label, 4, 18);
+    gfx_PrintStringXY("t", 68, 18);
+    gfx_PrintStringXY("range", 132, 18);
+    gfx_PrintStringXY("max h", 196, 18);
+    gfx_PrintStringXY("|vf|", 260, 18);
+    gfx_SetColor(0);
+    gfx_HorizLine(2, 28, 316);
+
+    int end = top + SHEET_VISIBLE;
+    if (end > sheetCount) end = sheetCount;
+    for (int r = top; r < end; r++) {
+        const ProjState<float>& row = sheetRows[r];
+        int y = 32 + (r - top) * 12;
+        if (r == sel) {
+            gfx_SetColor(inputMode ? 239 : 183);
+            gfx_FillRectangle(2, y - 2, 316, 12);
+        }
+        gfx_SetTextFGColor(0);
+        float val;
+        if (r == sel && inputMode) {
+            char text[15];
+            inputText(text);
+            gfx_PrintStringXY(text, 4, y);
         } else {
-            strcpy(fullStr, inputBuf);
+            const uint8_t* sigs = (sheetParamRow >= ROWS) ? row.extraSig : (sheetParamCol == 0) ? row.xSig : row.ySig;
+            int i = (sheetParamRow >= ROWS) ? sheetParamRow - ROWS : sheetParamRow;
+            drawSheetValue(getCell(row, sheetParamRow, sheetParamCol, &val), val, sigs[i], 4, y);
         }
-        
-        char* end;
-        real_t r = os_StrToReal(fullStr, &end);
-        float val = os_RealToFloat(&r);
-        
-        if (curRow < ROWS) {
-            if (curCol == 0) {
-                xVals[curRow] = val;
-                xKnown[curRow] = true;
-                xUserSet[curRow] = true;
-            } else {
-                yVals[curRow] = val;
-                yKnown[curRow] = true;
-                yUserSet[curRow] = true;
+        gfx_SetTextFGColor(24);
+        uint8_t sig;
+        drawSheetValue(row.xKnown & BIT(6), row.xVals[6], row.xSig[6], 68, y);
+        drawSheetValue(row.xKnown & BIT(5), row.xVals[5], row.xSig[5], 132, y);
+        drawSheetValue(maxHeight(row, &val, &sig), val, sig, 196, y);
+        drawSheetValue(row.extraKnown & BIT(EX_VF), row.extraVals[EX_VF], row.extraSig[EX_VF], 260, y);
+    }
+
+    gfx_SetTextFGColor(160);
+    gfx_SetTextXY(4, 215);
+    gfx_PrintInt(sel + 1, 1);
+    gfx_PrintChar('/');
+    gfx_PrintInt(sheetCount, 1);
+    gfx_PrintStringXY("+: add row   del: remove row", 60, 215);
+    gfx_PrintStringXY("clear: return", 115, 227);
+}
+
+void commitSheetInput(int row) {
+    if (inputLen > 0 || isNegative) {
+        setCell(sheetRows[row], sheetParamRow, sheetParamCol, true, parseInput(), countSigFigs(inputBuf));
+        autoSolve(sheetRows[row], NULL, NULL);
+    }
+    inputMode = false;
+}
+
+// Rows start as copies of the table; the parameter column is the cell that
+// was selected when the sheet was opened.
+void runSheet() {
+    if (sheetCount == 0 || sheetParamRow != curRow || sheetParamCol != curCol) {
+        sheetRows[0] = st;
+        sheetCount = 1;
+        sheetParamRow = curRow;
+        sheetParamCol = curCol;
+    }
+    int sel = 0, top = 0;
+    bool prevUp = true, prevDown = true, prevEnter = true, prevClear = true;
+    bool prevDel = true, prevAdd = true, prevYequ = true, prevNeg = true, prevDot = true;
+    bool prevKeys[10];
+    readDigitKeys(prevKeys);
+
+    while (true) {
+        drawSheet(sel, top);
+        gfx_BlitBuffer();
+
+        kb_Scan();
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool add = kb_Data[6] & kb_Add;
+        bool yequ = kb_Data[1] & kb_Yequ;
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+
+        int move = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+
+        if (!inputMode) {
+            if ((clear && !prevClear) || (yequ && !prevYequ)) break;
+            if (enter && !prevEnter) startInput();
+            else startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+            if (add && !prevAdd && sheetCount < SHEET_MAX) {
+                memmove(&sheetRows[sel + 2], &sheetRows[sel + 1], (sheetCount - sel - 1) * sizeof(sheetRows[0]));
+                sheetRows[sel + 1] = sheetRows[sel];
+                sheetCount++;
+                move = 1;
+            }
+            if (del && !prevDel && sheetCount > 1) {
+                memmove(&sheetRows[sel], &sheetRows[sel + 1], (sheetCount - sel - 1) * sizeof(sheetRows[0]));
+                sheetCount--;
+                if (sel >= sheetCount) sel = sheetCount - 1;
             }
-        } else if (curRow == ROWS) {
-            launchSpeed = val;
-            speedKnown = true;
-            speedUserSet = true;
-        } else if (curRow == ROWS + 1) {
-            launchAngle = val;
-            angleKnown = true;
-            angleUserSet = true;
         } else {
-            finalSpeed = val;
-            finalSpeedKnown = true;
-            finalSpeedUserSet = true;
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel);
+            if ((enter && !prevEnter) || move) commitSheetInput(sel);
+            if (clear && !prevClear) cancelInput();
         }
-        
-        autoSolve();
+
+        sel += move;
+        if (sel < 0) sel = 0;
+        if (sel >= sheetCount) sel = sheetCount - 1;
+        if (sel < top) top = sel;
+        if (sel >= top + SHEET_VISIBLE) top = sel - SHEET_VISIBLE + 1;
+
+        prevUp = up; prevDown = down; prevEnter = enter; prevClear = clear;
+        prevDel = del; prevAdd = add; prevYequ = yequ; prevNeg = neg; prevDot = dot;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
     }
     inputMode = false;
+    waitKeyRelease();
 }
 
-void cancelInput() {
-    inputMode = false;
+#define RULE_ANY 0
+#define RULE_NONZERO 1
+#define RULE_ZERO 2
+
+#define QUIZ_SLOTS 8
+#define QUIZ_MAX 32
+#define QUIZ_TOLERANCE 0.01f
+
+struct QuizRule {
+    uint8_t need, gives, when;
+};
+
+// trySolve's rules as known-masks, leaving out the sqrt rules whose sign is a
+// guess. The quadratic time rules stay: the solver takes the later root, and
+// every quiz lands after its apex.
+constexpr QuizRule quizRules[] = {
+    {BIT(0) | BIT(1), BIT(5), RULE_ANY},
+    {BIT(0) | BIT(5), BIT(1), RULE_ANY},
+    {BIT(1) | BIT(5), BIT(0), RULE_ANY},
+    {BIT(2) | BIT(3) | BIT(4), BIT(6) | BIT(5), RULE_NONZERO},
+    {BIT(2) | BIT(4), BIT(3), RULE_ZERO},
+    {BIT(3) | BIT(4), BIT(2), RULE_ZERO},
+    {BIT(2) | BIT(4) | BIT(6), BIT(3) | BIT(5), RULE_ANY},
+    {BIT(3) | BIT(4) | BIT(6), BIT(2) | BIT(5), RULE_ANY},
+    {BIT(2) | BIT(3) | BIT(6), BIT(4) | BIT(5), RULE_ANY},
+    {BIT(2) | BIT(5) | BIT(6), BIT(3) | BIT(4), RULE_ANY},
+    {BIT(3) | BIT(5) | BIT(6), BIT(2) | BIT(4), RULE_ANY},
+    {BIT(4) | BIT(5) | BIT(6), BIT(2) | BIT(3), RULE_ANY},
+    {BIT(2) | BIT(3) | BIT(5), BIT(4) | BIT(6), RULE_ANY},
+    {BIT(2) | BIT(4) | BIT(5), BIT(6), RULE_ANY},
+    {BIT(3) | BIT(4) | BIT(5), BIT(6), RULE_ANY},
+};
+
+// Every row reachable from each 7-bit known-mask; [1] is for an axis with a = 0.
+struct ClosureTable {
+    uint8_t mask[2][128];
+    constexpr ClosureTable() : mask() {
+        for (int z = 0; z < 2; z++) {
+            for (int m = 0; m < 128; m++) {
+                uint8_t c = m, prev = 0;
+                while (c != prev) {
+                    prev = c;
+                    for (const QuizRule& r : quizRules) {
+                        if (r.when == (z ? RULE_NONZERO : RULE_ZERO)) continue;
+                        if ((c & r.need) == r.need) c |= r.gives;
+                    }
+                }
+                mask[z][m] = c;
+            }
+        }
+    }
+};
+
+constexpr ClosureTable closureTable;
+
+// The values a problem can give, as {x rows, y rows}: speed and angle, x v0,
+// range, time, launch height, landing height, y v0, y vf.
+constexpr uint8_t quizSlotBits[QUIZ_SLOTS][2] = {
+    {BIT(2), BIT(2)}, {BIT(2), 0}, {BIT(5), 0}, {BIT(6), 0},
+    {0, BIT(0)}, {0, BIT(1)}, {0, BIT(2)}, {0, BIT(3)},
+};
+const int8_t quizSlotRow[QUIZ_SLOTS] = {ROWS, 2, 5, 6, 0, 1, 2, 3};
+const int8_t quizSlotCol[QUIZ_SLOTS] = {0, 0, 0, 0, 1, 1, 1, 1};
+
+constexpr bool quizWellPosed(int slots) {
+    uint8_t x = BIT(0) | BIT(4), y = BIT(4);
+    for (int i = 0; i < QUIZ_SLOTS; i++) {
+        if (slots & BIT(i)) {
+            x |= quizSlotBits[i][0];
+            y |= quizSlotBits[i][1];
+        }
+    }
+    for (int pass = 0; pass < 3; pass++) {
+        x = closureTable.mask[1][x];
+        y = closureTable.mask[0][y];
+        if ((x | y) & BIT(6)) { x |= BIT(6); y |= BIT(6); }
+    }
+    return x == 0x7F && y == 0x7F;
 }
 
-void clearCell() {
-    if (curRow < ROWS) {
-        if (curCol == 0) {
-            xKnown[curRow] = false;
-            xUserSet[curRow] = false;
-            xVals[curRow] = 0;
+// Every minimal set of givens that pins down the whole table.
+struct QuizTable {
+    uint8_t slots[QUIZ_MAX];
+    int count;
+    constexpr QuizTable() : slots(), count(0) {
+        for (int c = 1; c < BIT(QUIZ_SLOTS); c++) {
+            if (!quizWellPosed(c)) continue;
+            bool minimal = true;
+            for (int i = 0; i < QUIZ_SLOTS; i++) {
+                if ((c & BIT(i)) && quizWellPosed(c & ~BIT(i))) minimal = false;
+            }
+            if (minimal && count < QUIZ_MAX) slots[count++] = c;
+        }
+    }
+};
+
+constexpr QuizTable quizTable;
+static_assert(quizTable.count > 0 && quizTable.count < QUIZ_MAX, "QUIZ_MAX too small");
+
+// What a problem can ask for; a target is skipped when its slot is a given.
+struct QuizTarget {
+    int8_t row, col, slot;
+};
+
+const QuizTarget quizTargets[] = {
+    {5, 0, 2}, {6, 0, 3}, {3, 1, 7}, {2, 1, 6}, {2, 0, 1},
+    {0, 1, 4}, {ROWS, 0, 0}, {ROWS + 1, 0, 0}, {ROWS + 2, 0, -1},
+};
+
+struct Quiz {
+    ProjState<float> given;
+    uint8_t slots;
+    const QuizTarget* target;
+    float answer;
+    int8_t result;
+};
+
+Quiz quiz;
+uint32_t quizRng = 0;
+
+float roundSig(float v, int sig) {
+    if (v == 0) return 0;
+    int k = sig - 1 - decExponent(v < 0 ? -v : v);
+    return scalePow10(roundf(scalePow10(v, k)), -k);
+}
+
+void copyGiven(const ProjState<float>& truth, int row, int col) {
+    float val;
+    getCell(truth, row, col, &val);
+    setCell(quiz.given, row, col, true, roundSig(val, 4), 4);
+}
+
+// Samples a launch that lands at or below its start, shows a random minimal
+// set of givens, and solves those givens once for the answer key.
+void newQuiz() {
+    if (!quizRng) quizRng = rtc_Time() | 1;
+    ProjState<float> truth;
+    initData(truth);
+    setCell(truth, ROWS, 0, true, 10 + xorshift32(&quizRng) % 21);
+    setCell(truth, ROWS + 1, 0, true, 20 + xorshift32(&quizRng) % 51);
+    setCell(truth, 0, 1, true, xorshift32(&quizRng) % 31);
+    setCell(truth, 1, 1, true, 0);
+    autoSolve(truth, NULL, NULL);
+
+    quiz.slots = quizTable.slots[xorshift32(&quizRng) % quizTable.count];
+    initData(quiz.given);
+    for (int i = 0; i < QUIZ_SLOTS; i++) {
+        if (!(quiz.slots & BIT(i))) continue;
+        copyGiven(truth, quizSlotRow[i], quizSlotCol[i]);
+        if (i == 0) copyGiven(truth, ROWS + 1, 0);
+    }
+
+    const QuizTarget* open[sizeof(quizTargets) / sizeof(quizTargets[0])];
+    int n = 0;
+    for (const QuizTarget& t : quizTargets) {
+        if (t.slot < 0 || !(quiz.slots & BIT(t.slot))) open[n++] = &t;
+    }
+    quiz.target = open[xorshift32(&quizRng) % n];
+    autoSolve(quiz.given, NULL, NULL);
+    getCell(quiz.given, quiz.target->row, quiz.target->col, &quiz.answer);
+    quiz.result = 0;
+}
+
+bool quizCorrect(float val) {
+    float err = fabsf(val - quiz.answer);
+    return err <= QUIZ_TOLERANCE * fabsf(quiz.answer) || err < 0.01f;
+}
+
+int drawQuizGiven(int row, int col, int y) {
+    char label[8], buf[15];
+    float val;
+    getCell(quiz.given, row, col, &val);
+    cellLabel(row, col, label);
+    floatToStr(val, buf);
+    gfx_PrintStringXY(label, 30, y);
+    gfx_PrintStringXY(buf, 90, y);
+    gfx_PrintStringXY(cellUnits[row], 160, y);
+    return y + 12;
+}
+
+void drawQuiz() {
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("Practice problem", 96, 3);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("Given (g = 9.81 m/s^2):", 10, 20);
+
+    char label[8], buf[15];
+    int y = 36;
+    gfx_SetTextFGColor(0);
+    for (int i = 0; i < QUIZ_SLOTS; i++) {
+        if (!(quiz.slots & BIT(i))) continue;
+        y = drawQuizGiven(quizSlotRow[i], quizSlotCol[i], y);
+        if (i == 0) y = drawQuizGiven(ROWS + 1, 0, y);
+    }
+
+    cellLabel(quiz.target->row, quiz.target->col, label);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("Find:", 10, 110);
+    gfx_PrintStringXY(label, 60, 110);
+    gfx_PrintStringXY(cellUnits[quiz.target->row], 110, 110);
+
+    gfx_SetColor(inputMode ? 239 : 183);
+    gfx_FillRectangle(58, 126, 100, 13);
+    gfx_SetColor(0);
+    gfx_Rectangle(58, 126, 100, 13);
+    if (inputMode) {
+        inputText(buf);
+        gfx_PrintStringXY(buf, 61, 129);
+    }
+
+    if (quiz.result) {
+        gfx_SetTextFGColor(quiz.result > 0 ? 24 : 224);
+        gfx_PrintStringXY(quiz.result > 0 ? "Correct!" : "Not quite. Answer:", 10, 150);
+        if (quiz.result < 0) {
+            floatToStr(quiz.answer, buf);
+            gfx_PrintStringXY(buf, 160, 150);
+        }
+    }
+
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("enter: check   prgm: new problem", 30, 210);
+    gfx_PrintStringXY("clear: return", 115, 225);
+}
+
+void runQuiz() {
+    newQuiz();
+    bool prevEnter = true, prevClear = true, prevDel = true, prevPrgm = true;
+    bool prevNeg = true, prevDot = true;
+    bool prevKeys[10];
+    readDigitKeys(prevKeys);
+
+    while (true) {
+        drawQuiz();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool prgm = kb_Data[4] & kb_Prgm;
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+
+        if (!inputMode) {
+            if (clear && !prevClear) break;
+            if (prgm && !prevPrgm) newQuiz();
+            else if (startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot)) quiz.result = 0;
         } else {
-            yKnown[curRow] = false;
-            yUserSet[curRow] = false;
-            yVals[curRow] = 0;
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel);
+            if (enter && !prevEnter && (inputLen > 0 || isNegative)) {
+                quiz.result = quizCorrect(parseInput()) ? 1 : -1;
+                inputMode = false;
+            }
+            if (clear && !prevClear) cancelInput();
         }
-    } else if (curRow == ROWS) {
-        speedKnown = false;
-        speedUserSet = false;
-        launchSpeed = 0;
-    } else if (curRow == ROWS + 1) {
-        angleKnown = false;
-        angleUserSet = false;
-        launchAngle = 0;
-    } else {
-        finalSpeedKnown = false;
-        finalSpeedUserSet = false;
-        finalSpeed = 0;
+
+        prevEnter = enter; prevClear = clear; prevDel = del; prevPrgm = prgm;
+        prevNeg = neg; prevDot = dot;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
     }
-    autoSolve();
+    inputMode = false;
+    waitKeyRelease();
 }
 
 void resetAll() {
     initData();
+    labFit.mode = FIT_NONE;
 }
 
+// st goes first, as WORKEN reads it back on its own.
+const ModChunk stateChunks[] = {
+    {&st, sizeof(st)},
+    {xEqUsed, sizeof(xEqUsed)},
+    {yEqUsed, sizeof(yEqUsed)}
+};
+
 int main(void) {
     gfx_Begin();
     gfx_SetDrawBuffer();
 
-    initData();
+    // A resumed run gets its flags and equation lists back too, so nothing
+    // has to be solved again.
+    bool resume = resumeRequested(PROJ_STATE_VAR);
+    if (!resume || !loadModState(PROJ_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) initData();
 
     bool running = true;
     bool prevUp = false, prevDown = false, prevLeft = false, prevRight = false;
     bool prevEnter = false, prevClear = false, prevDel = false;
     bool prevMode = false, prevGraph = false, prevTrace = false;
+    bool prevWindow = false, prevStat = false, prevYequ = false, prevMath = false, prevPrgm = false;
+#ifdef VERIFY64
+    bool prevVars = false;
+#endif
     bool prevKeys[10] = {false};
     bool prevNeg = false, prevDot = false;
 
@@ -893,18 +1726,18 @@ int main(void) {
         bool mode = kb_Data[1] & kb_Mode;
         bool graph = kb_Data[1] & kb_Graph;
         bool trace = kb_Data[1] & kb_Trace;
+        bool window = kb_Data[1] & kb_Window;
+        bool stat = kb_Data[4] & kb_Stat;
+        bool yequ = kb_Data[1] & kb_Yequ;
+        bool math = kb_Data[2] & kb_Math;
+        bool prgm = kb_Data[4] & kb_Prgm;
+#ifdef VERIFY64
+        bool vars = kb_Data[5] & kb_Vars;
+#endif
 
-        bool keys[10];
-        keys[0] = kb_Data[3] & kb_0;
-        keys[1] = kb_Data[3] & kb_1;
-        keys[2] = kb_Data[4] & kb_2;
-        keys[3] = kb_Data[5] & kb_3;
-        keys[4] = kb_Data[3] & kb_4;
-        keys[5] = kb_Data[4] & kb_5;
-        keys[6] = kb_Data[5] & kb_6;
-        keys[7] = kb_Data[3] & kb_7;
-        keys[8] = kb_Data[4] & kb_8;
-        keys[9] = kb_Data[5] & kb_9;
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
         bool neg = kb_Data[5] & kb_Chs;
         bool dot = kb_Data[4] & kb_DecPnt;
 
@@ -951,51 +1784,19 @@ int main(void) {
             if (mode && !prevMode) resetAll();
             if (graph && !prevGraph) drawGraph();
             if (trace && !prevTrace) drawLegend();
+            if (window && !prevWindow) drawSweep();
+            if (stat && !prevStat) drawLabFit();
+            if (yequ && !prevYequ) runSheet();
+            if (math && !prevMath) sigFigMode = !sigFigMode;
+            if (prgm && !prevPrgm) runQuiz();
+#ifdef VERIFY64
+            if (vars && !prevVars) drawVerify();
+#endif
             if (clear && !prevClear) running = false;
             
-            for (int i = 0; i <= 9; i++) {
-                if (keys[i] && !prevKeys[i]) {
-                    startInput();
-                    inputBuf[0] = '0' + i;
-                    inputBuf[1] = '\0';
-                    inputLen = 1;
-                    break;
-                }
-            }
-            if (neg && !prevNeg) {
-                startInput();
-                isNegative = true;
-            }
-            if (dot && !prevDot) {
-                startInput();
-                inputBuf[0] = '.';
-                inputBuf[1] = '\0';
-                inputLen = 1;
-                hasDecimal = true;
-            }
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
         } else {
-            for (int i = 0; i <= 9; i++) {
-                if (keys[i] && !prevKeys[i] && inputLen < 10) {
-                    inputBuf[inputLen++] = '0' + i;
-                    inputBuf[inputLen] = '\0';
-                }
-            }
-            
-            if (dot && !prevDot && !hasDecimal && inputLen < 10) {
-                inputBuf[inputLen++] = '.';
-                inputBuf[inputLen] = '\0';
-                hasDecimal = true;
-            }
-            
-            if (neg && !prevNeg) {
-                isNegative = !isNegative;
-            }
-            
-            if (del && !prevDel && inputLen > 0) {
-                inputLen--;
-                if (inputBuf[inputLen] == '.') hasDecimal = false;
-                inputBuf[inputLen] = '\0';
-            }
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel);
             
             if (enter && !prevEnter) finishInput();
             if (clear && !prevClear) cancelInput();
@@ -1045,10 +1846,15 @@ int main(void) {
         prevUp = up; prevDown = down; prevLeft = left; prevRight = right;
         prevEnter = enter; prevClear = clear; prevDel = del;
         prevMode = mode; prevGraph = graph; prevTrace = trace;
+        prevWindow = window; prevStat = stat; prevYequ = yequ; prevMath = math; prevPrgm = prgm;
+#ifdef VERIFY64
+        prevVars = vars;
+#endif
         for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
         prevNeg = neg; prevDot = dot;
     }
     
+    saveModState(PROJ_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
     gfx_End();
     return 0;
 }
@@ -0,0 +1,538 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "degtrig.h"
+#include "arrow.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define SYS_RIVER 0
+#define SYS_PLANE 1
+#define SYS_RAIN 2
+#define SYS_COUNT 3
+
+// Three velocities tied by A/G = A/B + B/G, each held as magnitude, heading
+// (degrees counterclockwise from +x) and components.
+#define VEC_COUNT 3
+#define FIELDS 4
+#define V_AG 0
+#define V_AB 1
+#define V_BG 2
+#define F_MAG 0
+#define F_HDG 1
+#define F_X 2
+#define F_Y 3
+
+#define VEC_VARS (VEC_COUNT * FIELDS)
+#define X_DIST 12
+#define X_T 13
+#define X_DRIFT 14
+#define REL_MAX_VARS 15
+
+#define SOLVE_PASSES 4
+
+#define DIAG_CX 160
+#define DIAG_CY 122
+#define DIAG_SIZE 180
+
+struct RelState {
+    float vals[REL_MAX_VARS];
+    uint16_t known, userSet;
+};
+
+RelState systems[SYS_COUNT];
+int curSys = SYS_RIVER;
+
+int curRow = 0;
+int curCol = 0;
+
+const char* relTitles[SYS_COUNT] = {"BOAT AND CURRENT", "PLANE AND WIND", "RAIN AND CAR"};
+const char* vecLabels[SYS_COUNT][VEC_COUNT] = {
+    {"b/g", "b/w", "w/g"},
+    {"p/g", "p/a", "a/g"},
+    {"r/g", "r/c", "c/g"}
+};
+const int extraRows[SYS_COUNT] = {3, 2, 0};
+const char* extraLabels[SYS_COUNT][3] = {{"W", "t", "drift"}, {"d", "t", ""}, {"", "", ""}};
+const char* extraUnits[SYS_COUNT][3] = {{"m", "s", "m"}, {"m", "s", ""}, {"", "", ""}};
+const char* fieldTitles[FIELDS] = {"|v|", "hdg", "vx", "vy"};
+
+char eqUsed[64] = "";
+// Set when a heading and a magnitude fit two triangles (the ambiguous SSA
+// case); shown above the equations.
+char altNote[48] = "";
+
+int vi(int v, int f) {
+    return v * FIELDS + f;
+}
+
+void initData() {
+    memset(systems, 0, sizeof(systems));
+}
+
+bool isKnown(const RelState& s, int i) {
+    return s.known & BIT(i);
+}
+
+bool vecFull(const RelState& s, int v) {
+    int mask = 0xF << (v * FIELDS);
+    return (s.known & mask) == mask;
+}
+
+void derive(RelState& s, int i, float val, const char* eq) {
+    s.vals[i] = val;
+    s.known |= BIT(i);
+    addEq(eqUsed, eq);
+}
+
+// Fills in each vector's missing form. The conversions are gathered so all
+// vectors due for one go through the batch kernels together.
+void convertForms(RelState& s) {
+    float* v = s.vals;
+    float mag[VEC_COUNT], deg[VEC_COUNT], x[VEC_COUNT], y[VEC_COUNT];
+    int toXY[VEC_COUNT], toPolar[VEC_COUNT];
+    int nXY = 0, nPolar = 0;
+    for (int k = 0; k < VEC_COUNT; k++) {
+        bool m = isKnown(s, vi(k, F_MAG)), h = isKnown(s, vi(k, F_HDG));
+        bool cx = isKnown(s, vi(k, F_X)), cy = isKnown(s, vi(k, F_Y));
+        if (h && !m && (cx || cy)) {
+            float sn, cs;
+            sinCosDeg(v[vi(k, F_HDG)], &sn, &cs);
+            if (cx && fabsf(cs) > 1e-3f) derive(s, vi(k, F_MAG), v[vi(k, F_X)] / cs, "vx = |v|*cos(hdg)");
+            else if (cy && fabsf(sn) > 1e-3f) derive(s, vi(k, F_MAG), v[vi(k, F_Y)] / sn, "vy = |v|*sin(hdg)");
+            m = isKnown(s, vi(k, F_MAG));
+        }
+        if (m && h && !(cx && cy)) {
+            mag[nXY] = v[vi(k, F_MAG)];
+            deg[nXY] = v[vi(k, F_HDG)];
+            toXY[nXY++] = k;
+        } else if (cx && cy && !(m && h)) {
+            x[nPolar] = v[vi(k, F_X)];
+            y[nPolar] = v[vi(k, F_Y)];
+            toPolar[nPolar++] = k;
+        }
+    }
+
+    float ox[VEC_COUNT], oy[VEC_COUNT];
+    polarToXY(mag, deg, ox, oy, nXY);
+    for (int i = 0; i < nXY; i++) {
+        int k = toXY[i];
+        if (!isKnown(s, vi(k, F_X))) derive(s, vi(k, F_X), ox[i], "vx = |v|*cos(hdg)");
+        if (!isKnown(s, vi(k, F_Y))) derive(s, vi(k, F_Y), oy[i], "vy = |v|*sin(hdg)");
+    }
+    float om[VEC_COUNT], od[VEC_COUNT];
+    xyToPolar(x, y, om, od, nPolar);
+    for (int i = 0; i < nPolar; i++) {
+        int k = toPolar[i];
+        if (!isKnown(s, vi(k, F_MAG))) derive(s, vi(k, F_MAG), om[i], "|v| = sqrt(vx^2 + vy^2)");
+        if (!isKnown(s, vi(k, F_HDG)) && om[i] > 0) derive(s, vi(k, F_HDG), od[i], "hdg = atan2(vy, vx)");
+    }
+}
+
+// A/G = A/B + B/G holds axis by axis, so two known x parts give the third
+// whatever else is known.
+void addComponents(RelState& s) {
+    const char* eq = "A/G = A/B + B/G";
+    for (int f = F_X; f <= F_Y; f++) {
+        int a = vi(V_AG, f), b = vi(V_AB, f), c = vi(V_BG, f);
+        float* v = s.vals;
+        if (!isKnown(s, a) && isKnown(s, b) && isKnown(s, c)) derive(s, a, v[b] + v[c], eq);
+        if (isKnown(s, a) && !isKnown(s, b) && isKnown(s, c)) derive(s, b, v[a] - v[c], eq);
+        if (isKnown(s, a) && isKnown(s, b) && !isKnown(s, c)) derive(s, c, v[a] - v[b], eq);
+    }
+}
+
+void noteTwoFits(int v, float used, float other) {
+    char a[15], b[15];
+    floatToStr(used, a);
+    floatToStr(other, b);
+    strcpy(altNote, "|");
+    strcat(altNote, vecLabels[curSys][v]);
+    strcat(altNote, "| = ");
+    strcat(altNote, a);
+    strcat(altNote, " or ");
+    strcat(altNote, b);
+    strcat(altNote, ", first used");
+}
+
+// With one vector fully known the other two close a triangle P + Q = K.
+// Both headings known: two lines meet (a 2x2 solve). One heading and the
+// other magnitude: |K - s*uP| = |Q| is a quadratic in s. The larger root is
+// taken; when the smaller is positive too, both triangles are real and the
+// other answer is noted.
+void closeTriangle(RelState& s) {
+    float* v = s.vals;
+    for (int k = 0; k < VEC_COUNT; k++) {
+        if (!vecFull(s, k)) continue;
+        // P + sign*Q = K, with the vectors arranged to match A/G = A/B + B/G.
+        int p = (k == V_AG) ? V_AB : V_AG;
+        int q = (k == V_BG) ? V_AB : V_BG;
+        float turn = (k == V_AG) ? 0 : 180;
+        if (vecFull(s, p) || vecFull(s, q)) continue;
+
+        float kx = v[vi(k, F_X)], ky = v[vi(k, F_Y)];
+        bool hp = isKnown(s, vi(p, F_HDG)), hq = isKnown(s, vi(q, F_HDG));
+        bool mp = isKnown(s, vi(p, F_MAG)), mq = isKnown(s, vi(q, F_MAG));
+        float px, py, qx, qy;
+        if (hp) sinCosDeg(v[vi(p, F_HDG)], &py, &px);
+        if (hq) sinCosDeg(v[vi(q, F_HDG)] + turn, &qy, &qx);
+
+        if (hp && hq && !mp && !mq) {
+            float det = px * qy - py * qx;
+            if (fabsf(det) < 1e-6f) continue;
+            float sp = (kx * qy - ky * qx) / det;
+            float sq = (px * ky - py * kx) / det;
+            if (sp < 0 || sq < 0) continue;
+            derive(s, vi(p, F_MAG), sp, "two headings meet");
+            derive(s, vi(q, F_MAG), sq, "two headings meet");
+        } else if ((hp && !mp && mq && !hq) || (hq && !mq && mp && !hp)) {
+            int u = hp ? p : q;
+            float ux = hp ? px : qx, uy = hp ? py : qy;
+            float other = hp ? v[vi(q, F_MAG)] : v[vi(p, F_MAG)];
+            float b = ux * kx + uy * ky;
+            float r1, r2;
+            if (!solveQuadratic(1.0f, -2 * b, kx * kx + ky * ky - other * other, &r1, &r2)) continue;
+            float root = (r1 > r2) ? r1 : r2;
+            float low = (r1 > r2) ? r2 : r1;
+            if (root < 0) continue;
+            derive(s, vi(u, F_MAG), root, "|K - s*u| = |other|");
+            if (low > 0) noteTwoFits(u, root, low);
+        }
+    }
+}
+
+// River rows: the bank runs along the current (w/g), W is measured straight
+// across it. Plane rows: d is the distance along the ground track.
+void solveExtras(RelState& s) {
+    float* v = s.vals;
+    if (curSys == SYS_PLANE) {
+        float g = v[vi(V_AG, F_MAG)];
+        bool hasG = isKnown(s, vi(V_AG, F_MAG));
+        if (hasG && g > 0 && isKnown(s, X_DIST) && !isKnown(s, X_T)) derive(s, X_T, v[X_DIST] / g, "t = d/|p/g|");
+        if (hasG && isKnown(s, X_T) && !isKnown(s, X_DIST)) derive(s, X_DIST, g * v[X_T], "t = d/|p/g|");
+        return;
+    }
+    if (curSys != SYS_RIVER) return;
+    if (!vecFull(s, V_AG) || !isKnown(s, vi(V_BG, F_HDG))) return;
+    float sn, cs;
+    sinCosDeg(v[vi(V_BG, F_HDG)], &sn, &cs);
+    float along = v[vi(V_AG, F_X)] * cs + v[vi(V_AG, F_Y)] * sn;
+    float across = v[vi(V_AG, F_Y)] * cs - v[vi(V_AG, F_X)] * sn;
+    if (across <= 0) return;
+    if (isKnown(s, X_DIST) && !isKnown(s, X_T)) derive(s, X_T, v[X_DIST] / across, "t = W/v_across");
+    if (isKnown(s, X_T) && !isKnown(s, X_DIST)) derive(s, X_DIST, across * v[X_T], "t = W/v_across");
+    if (isKnown(s, X_T) && !isKnown(s, X_DRIFT)) derive(s, X_DRIFT, along * v[X_T], "drift = v_along*t");
+}
+
+void autoSolve() {
+    RelState& s = systems[curSys];
+    eqUsed[0] = '\0';
+    altNote[0] = '\0';
+    s.known &= s.userSet;
+    for (int pass = 0; pass < SOLVE_PASSES; pass++) {
+        convertForms(s);
+        addComponents(s);
+        closeTriangle(s);
+        solveExtras(s);
+    }
+}
+
+void setCell(int i, bool set, float val) {
+    RelState& s = systems[curSys];
+    s.vals[i] = set ? val : 0;
+    if (set) {
+        s.known |= BIT(i);
+        s.userSet |= BIT(i);
+    } else {
+        s.known &= ~BIT(i);
+        s.userSet &= ~BIT(i);
+    }
+}
+
+// Closed-form best heading for the boat, turned upstream from straight across
+// by a. Least time: a = 0, all of the boat's speed goes across. Least drift:
+// sin(a) = min(vb, vc)/max(vb, vc), which is zero drift when the boat is the
+// faster and otherwise minimizes drift/W = (vc - vb*sin a)/(vb*cos a).
+bool aimBoat(bool leastDrift) {
+    RelState& s = systems[curSys];
+    if (curSys != SYS_RIVER || !isKnown(s, vi(V_AB, F_MAG)) || !isKnown(s, vi(V_BG, F_MAG)) ||
+        !isKnown(s, vi(V_BG, F_HDG))) {
+        return false;
+    }
+    float vb = s.vals[vi(V_AB, F_MAG)], vc = s.vals[vi(V_BG, F_MAG)];
+    float a = 0;
+    if (leastDrift && vb > 0 && vc > 0) a = asinf(((vb < vc) ? vb : vc) / ((vb < vc) ? vc : vb)) * (180 / 3.14159265f);
+    float hdg = s.vals[vi(V_BG, F_HDG)] + 90 + a;
+    if (hdg >= 360) hdg -= 360;
+
+    for (int f = 0; f < FIELDS; f++) setCell(vi(V_AG, f), false, 0);
+    // The speed may only have been derived from x and y, so it is kept as a
+    // user value or autoSolve would drop it along with them.
+    setCell(vi(V_AB, F_X), false, 0);
+    setCell(vi(V_AB, F_Y), false, 0);
+    setCell(vi(V_AB, F_MAG), true, vb);
+    setCell(vi(V_AB, F_HDG), true, hdg);
+    if (isKnown(s, X_DIST)) {
+        setCell(X_T, false, 0);
+        setCell(X_DRIFT, false, 0);
+    }
+    autoSolve();
+    return true;
+}
+
+// B/G from the origin, A/B from its tip, and A/G closing the triangle. The
+// endpoints are scaled to pixels once and everything after is integer.
+void runDiagram() {
+    const RelState& s = systems[curSys];
+    for (int k = 0; k < VEC_COUNT; k++) {
+        if (!vecFull(s, k)) {
+            drawMessage("Solve all three vectors first");
+            return;
+        }
+    }
+    const float* v = s.vals;
+    float cx = v[vi(V_BG, F_X)], cy = v[vi(V_BG, F_Y)];
+    float ax = v[vi(V_AG, F_X)], ay = v[vi(V_AG, F_Y)];
+    float minX = fminf(0, fminf(cx, ax)), maxX = fmaxf(0, fmaxf(cx, ax));
+    float minY = fminf(0, fminf(cy, ay)), maxY = fmaxf(0, fmaxf(cy, ay));
+    float span = fmaxf(maxX - minX, maxY - minY);
+    if (span <= 0) span = 1;
+    float scale = DIAG_SIZE / span;
+    float midX = 0.5f * (minX + maxX), midY = 0.5f * (minY + maxY);
+
+    int ox = DIAG_CX - (int)(midX * scale), oy = DIAG_CY + (int)(midY * scale);
+    int px = ox + (int)(cx * scale), py = oy - (int)(cy * scale);
+    int qx = ox + (int)(ax * scale), qy = oy - (int)(ay * scale);
+
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY(relTitles[curSys], 5, 4);
+    const uint8_t colors[VEC_COUNT] = {224, 24, 7};
+    const int ends[VEC_COUNT][4] = {{ox, oy, qx, qy}, {px, py, qx, qy}, {ox, oy, px, py}};
+    for (int k = 0; k < VEC_COUNT; k++) {
+        gfx_SetColor(colors[k]);
+        drawArrow(ends[k][0], ends[k][1], ends[k][2], ends[k][3]);
+        gfx_SetTextFGColor(colors[k]);
+        gfx_PrintStringXY(vecLabels[curSys][k], 5, 20 + k * 12);
+        gfx_PrintStringXY(vecLabels[curSys][k], (ends[k][0] + ends[k][2]) / 2 + 4, (ends[k][1] + ends[k][3]) / 2 - 4);
+    }
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("Any key to return", 101, 228);
+    gfx_BlitBuffer();
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+int rowCount() {
+    return VEC_COUNT + extraRows[curSys];
+}
+
+int cellIndex(int row, int col) {
+    return (row < VEC_COUNT) ? vi(row, col) : VEC_VARS + row - VEC_COUNT;
+}
+
+void drawCell(const RelState& s, int row, int col, int x, int y, int boxW, int rowH) {
+    int i = cellIndex(row, col);
+    bool selected = (row == curRow && col == curCol && !inputMode);
+    bool editing = (row == curRow && col == curCol && inputMode);
+    if (selected) {
+        gfx_SetColor(183);
+        gfx_FillRectangle(x, y, boxW, rowH - 2);
+    } else if (editing) {
+        gfx_SetColor(239);
+        gfx_FillRectangle(x, y, boxW, rowH - 2);
+    }
+    gfx_SetColor(0);
+    gfx_Rectangle(x, y, boxW, rowH - 2);
+
+    char buf[15];
+    if (editing) {
+        inputText(buf);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else if (isKnown(s, i)) {
+        floatToStr(s.vals[i], buf);
+        gfx_SetTextFGColor((s.userSet & BIT(i)) ? 0 : 24);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else {
+        gfx_PrintStringXY("?", x + boxW / 2 - 4, y + 3);
+    }
+    gfx_SetTextFGColor(0);
+}
+
+void drawTable() {
+    const RelState& s = systems[curSys];
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("RELATIVE VELOCITY - Evan Kolberg", 32, 3);
+
+    int startX = 5;
+    int startY = 16;
+    int rowH = 15;
+    int labelW = 28;
+    int colW = 70;
+
+    for (int f = 0; f < FIELDS; f++) {
+        gfx_PrintStringXY(fieldTitles[f], startX + labelW + f * colW + 4, startY + 2);
+    }
+    gfx_SetColor(0);
+    gfx_HorizLine(startX, startY + rowH - 2, labelW + colW * FIELDS);
+
+    for (int row = 0; row < VEC_COUNT; row++) {
+        int y = startY + rowH + row * rowH;
+        gfx_PrintStringXY(vecLabels[curSys][row], startX, y + 3);
+        for (int col = 0; col < FIELDS; col++) {
+            drawCell(s, row, col, startX + labelW + col * colW, y, colW - 2, rowH);
+        }
+    }
+
+    int extraY = startY + (VEC_COUNT + 1) * rowH + 6;
+    for (int r = 0; r < extraRows[curSys]; r++) {
+        int y = extraY + r * rowH;
+        gfx_PrintStringXY(extraLabels[curSys][r], startX, y + 3);
+        drawCell(s, VEC_COUNT + r, 0, startX + labelW + 12, y, colW - 2, rowH);
+        gfx_PrintStringXY(extraUnits[curSys][r], startX + labelW + colW + 16, y + 3);
+    }
+
+    int hintX = 166;
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY(relTitles[curSys], hintX, extraY);
+    gfx_PrintStringXY("m/s, deg from +x", hintX, extraY + 10);
+    gfx_PrintStringXY("y=: switch system", hintX, extraY + 24);
+    gfx_PrintStringXY("graph: diagram", hintX, extraY + 34);
+    if (curSys == SYS_RIVER) {
+        gfx_PrintStringXY("window: least time", hintX, extraY + 44);
+        gfx_PrintStringXY("zoom: least drift", hintX, extraY + 54);
+    }
+    gfx_PrintStringXY("del: clear cell", hintX, extraY + 64);
+    gfx_PrintStringXY("mode: reset", hintX, extraY + 74);
+    gfx_PrintStringXY("clear: quit", hintX, extraY + 84);
+
+    int eqY = extraY + 96;
+    if (altNote[0]) {
+        gfx_SetTextFGColor(224);
+        gfx_PrintStringXY(altNote, 5, eqY);
+        eqY += 10;
+    }
+    gfx_SetTextFGColor(24);
+    printEqList(eqUsed, eqY);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(cellIndex(curRow, curCol), true, parseInput());
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(cellIndex(curRow, curCol), false, 0);
+    autoSolve();
+}
+
+// All three systems, which one is showing, its equations and any note of
+// a second triangle.
+const ModChunk stateChunks[] = {
+    {systems, sizeof(systems)},
+    {&curSys, sizeof(curSys)},
+    {eqUsed, sizeof(eqUsed)},
+    {altNote, sizeof(altNote)}
+};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(REL_STATE_VAR);
+    if (!resume || !loadModState(REL_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevLeft = false, prevRight = false;
+    bool prevEnter = false, prevClear = false, prevDel = false, prevMode = false;
+    bool prevGraph = false, prevYequ = false, prevWindow = false, prevZoom = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool left = kb_Data[7] & kb_Left;
+        bool right = kb_Data[7] & kb_Right;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool yequ = kb_Data[1] & kb_Yequ;
+        bool window = kb_Data[1] & kb_Window;
+        bool zoom = kb_Data[1] & kb_Zoom;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0, side = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+        if (left && !prevLeft) side = -1;
+        if (right && !prevRight) side = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (yequ && !prevYequ) {
+                curSys = (curSys + 1) % SYS_COUNT;
+                curRow = curCol = 0;
+                autoSolve();
+            }
+            if ((window && !prevWindow) || (zoom && !prevZoom)) {
+                if (curSys == SYS_RIVER && !aimBoat(zoom)) drawMessage("Need |b/w| and all of w/g");
+            }
+            if (graph && !prevGraph) runDiagram();
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move || side) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        int rows = rowCount();
+        curRow = (curRow + move + rows) % rows;
+        curCol = (curRow < VEC_COUNT) ? (curCol + side + FIELDS) % FIELDS : 0;
+
+        prevUp = up; prevDown = down; prevLeft = left; prevRight = right;
+        prevEnter = enter; prevClear = clear; prevDel = del; prevMode = mode;
+        prevGraph = graph; prevYequ = yequ; prevWindow = window; prevZoom = zoom; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(REL_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
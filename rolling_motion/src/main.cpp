@@ -0,0 +1,553 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "degtrig.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define GRAVITY 9.81f
+#define PI 3.14159265f
+
+#define ROWS 7
+#define COLS 3
+#define COL_LIN 0
+#define COL_ANG 1
+#define COL_EXTRA 2
+
+#define RX_COUNT 4
+#define RX_R 0
+#define RX_RAMP 1
+#define RX_G 2
+#define RX_C 3
+
+#define SOLVE_PASSES 8
+
+#define SHAPE_COUNT 3
+
+#define RACE_LANES 4
+#define RACE_FRAMES 240
+#define FRAME_DT (1 / 30.0f)
+#define TRACK_LEFT 24
+#define TRACK_LEN 256
+#define WHEEL_R 8
+
+struct LinNames {
+    static constexpr const char* var[VAR_COUNT] = {"x0", "xf", "v0", "vf", "a", "dx", "t"};
+};
+
+struct AngNames {
+    static constexpr const char* var[VAR_COUNT] = {"th0", "thf", "w0", "wf", "al", "dth", "t"};
+};
+
+// Motion along the ramp and the turning of the body are two copies of the
+// kinematics row set, tied by rolling without slipping (x = th*R, v = w*R,
+// a = al*R, shared t) and driven by a = g*sin(ramp)/(1 + c), c = I/(m*R^2).
+struct RollState {
+    float linVals[VAR_COUNT];
+    float angVals[VAR_COUNT];
+    float extra[RX_COUNT];
+    uint8_t linSig[VAR_COUNT], angSig[VAR_COUNT], extraSig[RX_COUNT];
+    uint8_t linKnown, angKnown, extraKnown;
+    uint8_t linUserSet, angUserSet, extraUserSet;
+};
+
+RollState st;
+int curShape = 0;
+
+int curRow = 0;
+int curCol = 0;
+
+const char* shapeNames[SHAPE_COUNT] = {"solid sphere", "solid cylinder", "hoop"};
+const float shapeC[SHAPE_COUNT] = {0.4f, 0.5f, 1};
+
+const char* extraLabels[RX_COUNT] = {"R:", "ramp:", "g:", "c:"};
+const char* linUnits[VAR_COUNT] = {"m", "m", "m/s", "m/s", "m/s^2", "m", "s"};
+const char* angUnits[VAR_COUNT] = {"rad", "rad", "rad/s", "rad/s", "rad/s^2", "rad", "s"};
+const char* extraUnits[RX_COUNT] = {"m", "deg", "m/s^2", "I/(mR^2)"};
+
+char linEqUsed[64] = "";
+char angEqUsed[64] = "";
+char linkEqUsed[64] = "";
+
+void setExtra(int i, bool set, float val, uint8_t sig = SIG_EXACT) {
+    st.extra[i] = set ? val : 0;
+    st.extraSig[i] = set ? sig : SIG_EXACT;
+    if (set) {
+        st.extraKnown |= BIT(i);
+        st.extraUserSet |= BIT(i);
+    } else {
+        st.extraKnown &= ~BIT(i);
+        st.extraUserSet &= ~BIT(i);
+    }
+}
+
+void initData() {
+    memset(&st, 0, sizeof(st));
+    st.linKnown = st.linUserSet = BIT(0);
+    setExtra(RX_G, true, GRAVITY);
+    setExtra(RX_C, true, shapeC[curShape]);
+}
+
+bool extraKnown(int i) {
+    return st.extraKnown & BIT(i);
+}
+
+void deriveExtra(int i, float val, uint8_t sig, const char* eq) {
+    st.extra[i] = val;
+    st.extraSig[i] = sig;
+    st.extraKnown |= BIT(i);
+    addEq(linkEqUsed, eq);
+}
+
+// The no-slip cross-rule: copies each row known on one side to the other
+// through R, or finds R from a row known on both.
+void couple(RollState& s) {
+    const char* linkEq[VAR_COUNT - 1] = {"x0 = th0*R", "xf = thf*R", "v0 = w0*R", "vf = wf*R", "a = al*R", "dx = dth*R"};
+    float r = s.extra[RX_R];
+    bool kr = s.extraKnown & BIT(RX_R);
+    for (int i = 0; i < VAR_COUNT - 1; i++) {
+        bool kl = s.linKnown & BIT(i);
+        bool ka = s.angKnown & BIT(i);
+        if (ka && !kl && kr) {
+            s.linVals[i] = s.angVals[i] * r;
+            s.linSig[i] = sigMin(s.angSig[i], s.extraSig[RX_R]);
+            s.linKnown |= BIT(i);
+            addEq(linkEqUsed, linkEq[i]);
+        } else if (kl && !ka && kr && r != 0) {
+            s.angVals[i] = s.linVals[i] / r;
+            s.angSig[i] = sigMin(s.linSig[i], s.extraSig[RX_R]);
+            s.angKnown |= BIT(i);
+            addEq(linkEqUsed, linkEq[i]);
+        } else if (kl && ka && !kr && s.angVals[i] != 0) {
+            deriveExtra(RX_R, s.linVals[i] / s.angVals[i], sigMin(s.linSig[i], s.angSig[i]), linkEq[i]);
+            r = s.extra[RX_R];
+            kr = true;
+        }
+    }
+
+    if ((s.angKnown & BIT(6)) && !(s.linKnown & BIT(6))) {
+        s.linVals[6] = s.angVals[6];
+        s.linSig[6] = s.angSig[6];
+        s.linKnown |= BIT(6);
+    } else if ((s.linKnown & BIT(6)) && !(s.angKnown & BIT(6))) {
+        s.angVals[6] = s.linVals[6];
+        s.angSig[6] = s.linSig[6];
+        s.angKnown |= BIT(6);
+    }
+}
+
+// a = g*sin(ramp)/(1 + c), solved for whichever one of the four is missing.
+void applyDynamics(RollState& s) {
+    const char* eq = "a = g*sin(ramp)/(1 + c)";
+    float* x = s.extra;
+    bool ka = s.linKnown & BIT(4);
+    bool kg = extraKnown(RX_G), kramp = extraKnown(RX_RAMP), kc = extraKnown(RX_C);
+    uint8_t sa = s.linSig[4], sg = s.extraSig[RX_G], sr = s.extraSig[RX_RAMP], sc = s.extraSig[RX_C];
+    float sn = 0, cs;
+    if (kramp) sinCosDeg(x[RX_RAMP], &sn, &cs);
+
+    if (!ka && kg && kramp && kc && x[RX_C] > -1) {
+        s.linVals[4] = x[RX_G] * sn / (1 + x[RX_C]);
+        s.linSig[4] = sigMin(sigMin(sg, sr), sc);
+        s.linKnown |= BIT(4);
+        addEq(linkEqUsed, eq);
+    } else if (ka && kg && kc && !kramp && x[RX_G] != 0) {
+        float ratio = s.linVals[4] * (1 + x[RX_C]) / x[RX_G];
+        if (ratio >= -1 && ratio <= 1) deriveExtra(RX_RAMP, asinf(ratio) * (180 / PI), sigMin(sigMin(sa, sg), sc), eq);
+    } else if (ka && kg && kramp && !kc && s.linVals[4] != 0) {
+        deriveExtra(RX_C, x[RX_G] * sn / s.linVals[4] - 1, sigMin(sigMin(sa, sg), sr), eq);
+    } else if (ka && kramp && kc && !kg && sn != 0) {
+        deriveExtra(RX_G, s.linVals[4] * (1 + x[RX_C]) / sn, sigMin(sigMin(sa, sr), sc), eq);
+    }
+}
+
+// Both engines and the cross-rules take turns until a pass adds nothing, so
+// a value any of them finds reaches the others in the same solve.
+void autoSolve() {
+    linEqUsed[0] = '\0';
+    angEqUsed[0] = '\0';
+    linkEqUsed[0] = '\0';
+
+    st.linKnown &= st.linUserSet;
+    st.angKnown &= st.angUserSet;
+    st.extraKnown &= st.extraUserSet;
+
+    for (int pass = 0; pass < SOLVE_PASSES; pass++) {
+        uint8_t before[3] = {st.linKnown, st.angKnown, st.extraKnown};
+        applyDynamics(st);
+        couple(st);
+        st.linKnown = trySolve<LinNames>(st.linVals, st.linSig, st.linKnown, st.linUserSet, linEqUsed);
+        couple(st);
+        st.angKnown = trySolve<AngNames>(st.angVals, st.angSig, st.angKnown, st.angUserSet, angEqUsed);
+        couple(st);
+        applyDynamics(st);
+        if (before[0] == st.linKnown && before[1] == st.angKnown && before[2] == st.extraKnown) break;
+    }
+}
+
+void setCell(int row, int col, bool set, float val, uint8_t sig = SIG_EXACT) {
+    if (col == COL_EXTRA) {
+        setExtra(row, set, val, sig);
+        return;
+    }
+    float* vals = (col == COL_LIN) ? st.linVals : st.angVals;
+    uint8_t* sigs = (col == COL_LIN) ? st.linSig : st.angSig;
+    uint8_t* known = (col == COL_LIN) ? &st.linKnown : &st.angKnown;
+    uint8_t* userSet = (col == COL_LIN) ? &st.linUserSet : &st.angUserSet;
+    vals[row] = set ? val : 0;
+    sigs[row] = set ? sig : SIG_EXACT;
+    if (set) {
+        *known |= BIT(row);
+        *userSet |= BIT(row);
+    } else {
+        *known &= ~BIT(row);
+        *userSet &= ~BIT(row);
+    }
+}
+
+// Pixel position and spoke angle of every racer for every frame, worked out
+// once from x = a*t^2/2 so the animation only has to look them up.
+struct Race {
+    int16_t pos[RACE_LANES][RACE_FRAMES];
+    int16_t spoke[RACE_LANES][RACE_FRAMES];
+    float finish[RACE_LANES];
+    int frames;
+    float dt;
+};
+
+Race race;
+
+const char* laneNames[RACE_LANES] = {"sphere", "cylinder", "hoop", "slide"};
+const float laneC[RACE_LANES] = {0.4f, 0.5f, 1, 0};
+
+// The slowest racer sets the length; a long race is sampled more coarsely
+// rather than running past RACE_FRAMES.
+bool buildRace(Race* r, float length, float g, float rampDeg) {
+    float sn, cs;
+    sinCosDeg(rampDeg, &sn, &cs);
+    float aSlow = g * sn / (1 + laneC[2]);
+    if (length <= 0 || aSlow <= 0) return false;
+    float tMax = sqrtf(2 * length / aSlow);
+    r->dt = FRAME_DT;
+    if (tMax / r->dt > RACE_FRAMES - 1) r->dt = tMax / (RACE_FRAMES - 1);
+    r->frames = (int)(tMax / r->dt) + 2;
+    if (r->frames > RACE_FRAMES) r->frames = RACE_FRAMES;
+
+    for (int k = 0; k < RACE_LANES; k++) {
+        float a = g * sn / (1 + laneC[k]);
+        r->finish[k] = sqrtf(2 * length / a);
+        for (int f = 0; f < r->frames; f++) {
+            float t = f * r->dt;
+            float x = (t < r->finish[k]) ? 0.5f * a * t * t : length;
+            int px = (int)(x / length * TRACK_LEN);
+            r->pos[k][f] = px;
+            // Turned so the drawn wheel rolls without slipping along the track.
+            r->spoke[k][f] = (laneC[k] > 0) ? (int)(px * (180 / PI) / WHEEL_R) % 360 : 0;
+        }
+    }
+    return true;
+}
+
+void drawRace(const Race* r, int f, float length, float rampDeg) {
+    char buf[15];
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("ramp", 5, 4);
+    floatToStr(length, buf);
+    gfx_PrintStringXY(buf, 45, 4);
+    gfx_PrintStringXY("m at", 125, 4);
+    floatToStr(rampDeg, buf);
+    gfx_PrintStringXY(buf, 165, 4);
+    gfx_PrintStringXY("deg", 245, 4);
+
+    const uint8_t colors[RACE_LANES] = {224, 24, 7, 148};
+    for (int k = 0; k < RACE_LANES; k++) {
+        int y = 48 + k * 44;
+        int x = TRACK_LEFT + r->pos[k][f];
+        gfx_SetColor(0);
+        gfx_HorizLine(TRACK_LEFT - WHEEL_R, y + WHEEL_R + 1, TRACK_LEN + 2 * WHEEL_R);
+        gfx_SetColor(200);
+        gfx_VertLine(TRACK_LEFT + TRACK_LEN, y - WHEEL_R - 4, 2 * WHEEL_R + 6);
+
+        gfx_SetColor(colors[k]);
+        if (laneC[k] > 0) {
+            gfx_Circle(x, y, WHEEL_R);
+            if (k != 2) gfx_FillCircle(x, y, WHEEL_R - 3);
+            // Screen y points down, so a clockwise roll to the right turns
+            // the spoke the positive way here.
+            int deg = r->spoke[k][f];
+            gfx_SetColor(0);
+            gfx_Line(x, y, x + (int)(WHEEL_R * cosDeg(deg)), y + (int)(WHEEL_R * sinDeg(deg)));
+        } else {
+            gfx_FillRectangle(x - WHEEL_R, y - WHEEL_R, 2 * WHEEL_R, 2 * WHEEL_R + 1);
+        }
+
+        gfx_SetTextFGColor(colors[k]);
+        gfx_PrintStringXY(laneNames[k], TRACK_LEFT - WHEEL_R, y - WHEEL_R - 12);
+        if (f * r->dt >= r->finish[k]) {
+            floatToStr(r->finish[k], buf, 4);
+            gfx_PrintStringXY(buf, TRACK_LEFT + 120, y - WHEEL_R - 12);
+            gfx_PrintString(" s");
+        }
+    }
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("t:", 5, 218);
+    floatToStr(f * r->dt, buf, 4);
+    gfx_PrintStringXY(buf, 24, 218);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("enter: restart  clear: return", 40, 228);
+}
+
+// The ramp is the table's dx at the table's angle and g; every shape starts
+// from rest, whatever the table's v0.
+void runRace() {
+    if (!(st.linKnown & BIT(5)) || !extraKnown(RX_RAMP) || !extraKnown(RX_G)) {
+        drawMessage("Need dx, ramp and g");
+        return;
+    }
+    float length = fabsf(st.linVals[5]);
+    float rampDeg = st.extra[RX_RAMP];
+    if (!buildRace(&race, length, st.extra[RX_G], rampDeg)) {
+        drawMessage("Ramp must slope down");
+        return;
+    }
+    int f = 0;
+    bool running = true;
+    while (running) {
+        drawRace(&race, f, length, rampDeg);
+        gfx_BlitBuffer();
+        if (f < race.frames - 1) f++;
+
+        kb_Scan();
+        if (kb_Data[6] & kb_Clear) running = false;
+        if (kb_Data[6] & kb_Enter) {
+            f = 0;
+            waitKeyRelease();
+        }
+    }
+    waitKeyRelease();
+}
+
+void drawValueCell(bool selected, bool editing, bool known, bool userSet, float val, uint8_t sig, int x, int y, int w, int h) {
+    if (selected) {
+        gfx_SetColor(183);
+        gfx_FillRectangle(x, y, w, h);
+    } else if (editing) {
+        gfx_SetColor(239);
+        gfx_FillRectangle(x, y, w, h);
+    }
+    gfx_SetColor(0);
+    gfx_Rectangle(x, y, w, h);
+
+    char buf[15];
+    if (editing) {
+        gfx_SetTextFGColor(0);
+        inputText(buf);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else if (known) {
+        valueToStr(val, sig, buf);
+        gfx_SetTextFGColor(userSet ? 0 : 24);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else {
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("?", x + w / 2 - 4, y + 3);
+    }
+}
+
+void drawTable() {
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("ROLLING MOTION - Evan Kolberg", 45, 3);
+    if (sigFigMode) {
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("SF", 300, 3);
+        gfx_SetTextFGColor(0);
+    }
+
+    int startX = 5;
+    int startY = 16;
+    int colW = 68;
+    int rowH = 15;
+    int labelW = 56;
+
+    gfx_SetColor(0);
+    gfx_PrintStringXY("ramp", startX + labelW + 6, startY + 2);
+    gfx_PrintStringXY("turning", startX + labelW + colW + 6, startY + 2);
+    gfx_HorizLine(startX, startY + rowH - 2, labelW + colW * 2 + 10);
+
+    for (int row = 0; row < ROWS; row++) {
+        int y = startY + rowH + row * rowH;
+
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(LinNames::var[row], startX + 2, y + 3);
+        if (row < ROWS - 1) {
+            gfx_PrintChar('/');
+            gfx_PrintString(AngNames::var[row]);
+        }
+
+        for (int col = COL_LIN; col <= COL_ANG; col++) {
+            bool here = (row == curRow && col == curCol);
+            const float* vals = (col == COL_LIN) ? st.linVals : st.angVals;
+            const uint8_t* sigs = (col == COL_LIN) ? st.linSig : st.angSig;
+            uint8_t known = (col == COL_LIN) ? st.linKnown : st.angKnown;
+            uint8_t userSet = (col == COL_LIN) ? st.linUserSet : st.angUserSet;
+            drawValueCell(here && !inputMode, here && inputMode, known & BIT(row), userSet & BIT(row),
+                          vals[row], sigs[row], startX + labelW + col * colW, y, colW - 2, rowH - 2);
+        }
+    }
+
+    int rightColX = 208;
+    for (int i = 0; i < RX_COUNT; i++) {
+        int y = startY + rowH + i * rowH;
+        bool here = (curCol == COL_EXTRA && curRow == i);
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(extraLabels[i], rightColX, y + 3);
+        drawValueCell(here && !inputMode, here && inputMode, st.extraKnown & BIT(i), st.extraUserSet & BIT(i),
+                      st.extra[i], st.extraSig[i], rightColX + 44, y, 64, rowH - 2);
+    }
+
+    int y = startY + (RX_COUNT + 1) * rowH + 4;
+    gfx_SetTextFGColor(24);
+    const char* shape = "custom c";
+    for (int k = 0; k < SHAPE_COUNT; k++) {
+        if (extraKnown(RX_C) && st.extra[RX_C] == shapeC[k]) shape = shapeNames[k];
+    }
+    gfx_PrintStringXY(shape, rightColX, y);
+    const char* unit = (curCol == COL_EXTRA) ? extraUnits[curRow] : (curCol == COL_LIN ? linUnits[curRow] : angUnits[curRow]);
+    gfx_PrintStringXY("unit:", rightColX, y + 12);
+    gfx_PrintStringXY(unit, rightColX + 44, y + 12);
+    gfx_PrintStringXY("y=: shape", rightColX, y + 24);
+    gfx_PrintStringXY("graph: race", rightColX, y + 34);
+
+    int eqY = startY + rowH + ROWS * rowH + 8;
+    if (linEqUsed[0] || angEqUsed[0] || linkEqUsed[0]) {
+        gfx_PrintStringXY("Equations used:", 5, eqY);
+        eqY += 10;
+    }
+    eqY = printEqList(linkEqUsed, eqY);
+    eqY = printEqList(linEqUsed, eqY);
+    printEqList(angEqUsed, eqY);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(curRow, curCol, true, parseInput(), countSigFigs(inputBuf));
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, curCol, false, 0);
+    autoSolve();
+}
+
+void moveCursor(int dRow, int dCol) {
+    curCol = (curCol + dCol + COLS) % COLS;
+    int rows = (curCol == COL_EXTRA) ? RX_COUNT : ROWS;
+    if (curRow >= rows) curRow = rows - 1;
+    curRow = (curRow + dRow + rows) % rows;
+}
+
+// The table, the shape and all three equation lists.
+const ModChunk stateChunks[] = {
+    {&st, sizeof(st)},
+    {&curShape, sizeof(curShape)},
+    {linEqUsed, sizeof(linEqUsed)},
+    {angEqUsed, sizeof(angEqUsed)},
+    {linkEqUsed, sizeof(linkEqUsed)}
+};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(ROLL_STATE_VAR);
+    if (!resume || !loadModState(ROLL_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevLeft = false, prevRight = false;
+    bool prevEnter = false, prevClear = false, prevDel = false;
+    bool prevMode = false, prevGraph = false, prevYequ = false, prevMath = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool left = kb_Data[7] & kb_Left;
+        bool right = kb_Data[7] & kb_Right;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool yequ = kb_Data[1] & kb_Yequ;
+        bool math = kb_Data[2] & kb_Math;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int dRow = 0, dCol = 0;
+        if (up && !prevUp) dRow = -1;
+        if (down && !prevDown) dRow = 1;
+        if (left && !prevLeft) dCol = -1;
+        if (right && !prevRight) dCol = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (yequ && !prevYequ) {
+                curShape = (curShape + 1) % SHAPE_COUNT;
+                setExtra(RX_C, true, shapeC[curShape]);
+                autoSolve();
+            }
+            if (graph && !prevGraph) runRace();
+            if (math && !prevMath) sigFigMode = !sigFigMode;
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || dRow || dCol) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        if (dRow || dCol) moveCursor(dRow, dCol);
+
+        prevUp = up; prevDown = down; prevLeft = left; prevRight = right;
+        prevEnter = enter; prevClear = clear; prevDel = del;
+        prevMode = mode; prevGraph = graph; prevYequ = yequ; prevMath = math; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(ROLL_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
@@ -0,0 +1,403 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define PI 3.14159265f
+
+#define ROWS 7
+#define COLS 2
+#define COL_ANG 0
+#define COL_TAN 1
+#define RADIUS_ROW ROWS
+
+struct AngularNames {
+    static constexpr const char* var[VAR_COUNT] = {"th0", "thf", "w0", "wf", "al", "dth", "t"};
+};
+
+struct TangentialNames {
+    static constexpr const char* var[VAR_COUNT] = {"s0", "sf", "v0", "vf", "at", "ds", "t"};
+};
+
+// The angular and tangential columns are two copies of the kinematics row set,
+// tied together by the radius: s = th*r, v = w*r, a_t = al*r, and a shared t.
+struct RotState {
+    float angVals[VAR_COUNT];
+    float tanVals[VAR_COUNT];
+    float radius;
+    uint8_t angSig[VAR_COUNT], tanSig[VAR_COUNT], radiusSig;
+    uint8_t angKnown, tanKnown;
+    uint8_t angUserSet, tanUserSet;
+    bool radiusKnown, radiusUserSet;
+};
+
+RotState st;
+
+int curRow = 0;
+int curCol = 0;
+
+const char* angUnits[VAR_COUNT] = {"rad", "rad", "rad/s", "rad/s", "rad/s^2", "rad", "s"};
+const char* tanUnits[VAR_COUNT] = {"m", "m", "m/s", "m/s", "m/s^2", "m", "s"};
+
+char angEqUsed[64] = "";
+char tanEqUsed[64] = "";
+char linkEqUsed[64] = "";
+
+void initData() {
+    memset(&st, 0, sizeof(st));
+    st.angKnown = st.angUserSet = BIT(0);
+}
+
+// Copies every row known in one column into the other through r, or finds r
+// from a row known in both.
+void coupleColumns(RotState& s) {
+    const char* linkEq[VAR_COUNT - 1] = {"s0 = th0*r", "sf = thf*r", "v0 = w0*r", "vf = wf*r", "at = al*r", "ds = dth*r"};
+    for (int i = 0; i < VAR_COUNT - 1; i++) {
+        bool ka = s.angKnown & BIT(i);
+        bool kt = s.tanKnown & BIT(i);
+        if (ka && !kt && s.radiusKnown) {
+            s.tanVals[i] = s.angVals[i] * s.radius;
+            s.tanSig[i] = sigMin(s.angSig[i], s.radiusSig);
+            s.tanKnown |= BIT(i);
+            addEq(linkEqUsed, linkEq[i]);
+        } else if (kt && !ka && s.radiusKnown && s.radius != 0) {
+            s.angVals[i] = s.tanVals[i] / s.radius;
+            s.angSig[i] = sigMin(s.tanSig[i], s.radiusSig);
+            s.angKnown |= BIT(i);
+            addEq(linkEqUsed, linkEq[i]);
+        } else if (ka && kt && !s.radiusKnown && s.angVals[i] != 0) {
+            s.radius = s.tanVals[i] / s.angVals[i];
+            s.radiusSig = sigMin(s.tanSig[i], s.angSig[i]);
+            s.radiusKnown = true;
+            addEq(linkEqUsed, linkEq[i]);
+        }
+    }
+
+    if ((s.angKnown & BIT(6)) && !(s.tanKnown & BIT(6))) {
+        s.tanVals[6] = s.angVals[6];
+        s.tanSig[6] = s.angSig[6];
+        s.tanKnown |= BIT(6);
+    } else if ((s.tanKnown & BIT(6)) && !(s.angKnown & BIT(6))) {
+        s.angVals[6] = s.tanVals[6];
+        s.angSig[6] = s.tanSig[6];
+        s.angKnown |= BIT(6);
+    }
+}
+
+void autoSolve() {
+    angEqUsed[0] = '\0';
+    tanEqUsed[0] = '\0';
+    linkEqUsed[0] = '\0';
+
+    st.angKnown &= st.angUserSet;
+    st.tanKnown &= st.tanUserSet;
+    st.radiusKnown = st.radiusUserSet;
+
+    for (int pass = 0; pass < 3; pass++) {
+        coupleColumns(st);
+        st.angKnown = trySolve<AngularNames>(st.angVals, st.angSig, st.angKnown, st.angUserSet, angEqUsed);
+        coupleColumns(st);
+        st.tanKnown = trySolve<TangentialNames>(st.tanVals, st.tanSig, st.tanKnown, st.tanUserSet, tanEqUsed);
+    }
+    coupleColumns(st);
+}
+
+void setCell(int row, int col, bool set, float val, uint8_t sig = SIG_EXACT) {
+    if (row == RADIUS_ROW) {
+        st.radius = set ? val : 0;
+        st.radiusSig = set ? sig : SIG_EXACT;
+        st.radiusKnown = st.radiusUserSet = set;
+        return;
+    }
+    float* vals = (col == COL_ANG) ? st.angVals : st.tanVals;
+    uint8_t* sigs = (col == COL_ANG) ? st.angSig : st.tanSig;
+    uint8_t* known = (col == COL_ANG) ? &st.angKnown : &st.tanKnown;
+    uint8_t* userSet = (col == COL_ANG) ? &st.angUserSet : &st.tanUserSet;
+    vals[row] = set ? val : 0;
+    sigs[row] = set ? sig : SIG_EXACT;
+    if (set) {
+        *known |= BIT(row);
+        *userSet |= BIT(row);
+    } else {
+        *known &= ~BIT(row);
+        *userSet &= ~BIT(row);
+    }
+}
+
+void drawValueCell(bool selected, bool editing, bool known, bool userSet, float val, uint8_t sig, int x, int y, int w, int h) {
+    if (selected) {
+        gfx_SetColor(183);
+        gfx_FillRectangle(x, y, w, h);
+    } else if (editing) {
+        gfx_SetColor(239);
+        gfx_FillRectangle(x, y, w, h);
+    }
+    gfx_SetColor(0);
+    gfx_Rectangle(x, y, w, h);
+
+    char buf[15];
+    if (editing) {
+        gfx_SetTextFGColor(0);
+        inputText(buf);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else if (known) {
+        valueToStr(val, sig, buf);
+        gfx_SetTextFGColor(userSet ? 0 : 24);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else {
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY("?", x + w / 2 - 4, y + 3);
+    }
+}
+
+void drawTable() {
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("ROTATIONAL MOTION - Evan Kolberg", 45, 3);
+    if (sigFigMode) {
+        gfx_SetTextFGColor(24);
+        gfx_PrintStringXY("SF", 300, 3);
+        gfx_SetTextFGColor(0);
+    }
+
+    int startX = 5;
+    int startY = 16;
+    int colW = 68;
+    int rowH = 15;
+    int labelW = 56;
+
+    gfx_SetColor(0);
+    gfx_PrintStringXY("angular", startX + labelW + 6, startY + 2);
+    gfx_PrintStringXY("tangent", startX + labelW + colW + 6, startY + 2);
+    gfx_HorizLine(startX, startY + rowH - 2, labelW + colW * 2 + 10);
+
+    for (int row = 0; row < ROWS; row++) {
+        int y = startY + rowH + row * rowH;
+
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(AngularNames::var[row], startX + 2, y + 3);
+        if (row < ROWS - 1) {
+            gfx_PrintChar('/');
+            gfx_PrintString(TangentialNames::var[row]);
+        }
+
+        for (int col = 0; col < COLS; col++) {
+            bool here = (row == curRow && col == curCol);
+            const float* vals = (col == COL_ANG) ? st.angVals : st.tanVals;
+            const uint8_t* sigs = (col == COL_ANG) ? st.angSig : st.tanSig;
+            uint8_t known = (col == COL_ANG) ? st.angKnown : st.tanKnown;
+            uint8_t userSet = (col == COL_ANG) ? st.angUserSet : st.tanUserSet;
+            drawValueCell(here && !inputMode, here && inputMode, known & BIT(row), userSet & BIT(row),
+                          vals[row], sigs[row], startX + labelW + col * colW, y, colW - 2, rowH - 2);
+        }
+    }
+
+    int rightColX = 208;
+    int y = startY + rowH;
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("r:", rightColX, y + 3);
+    bool here = (curRow == RADIUS_ROW);
+    drawValueCell(here && !inputMode, here && inputMode, st.radiusKnown, st.radiusUserSet,
+                  st.radius, st.radiusSig, rightColX + 20, y, 64, rowH - 2);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("m", rightColX + 88, y + 3);
+
+    char buf[20];
+    y += 2 * rowH;
+    gfx_PrintStringXY("ac (m/s^2):", rightColX, y);
+    if (st.radiusKnown && (st.angKnown & BIT(3))) {
+        float ac = st.angVals[3] * st.angVals[3] * st.radius;
+        valueToStr(ac, sigMin(st.angSig[3], st.radiusSig), buf);
+        gfx_PrintStringXY(buf, rightColX + 8, y + 11);
+    } else {
+        gfx_PrintStringXY("?", rightColX + 8, y + 11);
+    }
+
+    y += 2 * rowH;
+    gfx_PrintStringXY("rev:", rightColX, y);
+    if (st.angKnown & BIT(5)) {
+        valueToStr(st.angVals[5] / (2 * PI), st.angSig[5], buf);
+        gfx_PrintStringXY(buf, rightColX + 36, y);
+    } else {
+        gfx_PrintStringXY("?", rightColX + 36, y);
+    }
+
+    y += rowH;
+    gfx_SetTextFGColor(24);
+    int unitRow = (curRow < ROWS) ? curRow : -1;
+    if (unitRow >= 0) {
+        gfx_PrintStringXY("unit:", rightColX, y);
+        gfx_PrintStringXY(curCol == COL_ANG ? angUnits[unitRow] : tanUnits[unitRow], rightColX + 44, y);
+    }
+
+    int eqY = startY + rowH + ROWS * rowH + 8;
+    if (angEqUsed[0] || tanEqUsed[0] || linkEqUsed[0]) {
+        gfx_PrintStringXY("Equations used:", 5, eqY);
+        eqY += 10;
+    }
+    eqY = printEqList(linkEqUsed, eqY, 220);
+    eqY = printEqList(angEqUsed, eqY, 220);
+    printEqList(tanEqUsed, eqY, 220);
+
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("[trace] legend", 210, 225);
+}
+
+const char* legendLines[] = {
+    "th0, thf: initial, final angle (rad)",
+    "w0, wf: initial, final ang. vel. (rad/s)",
+    "al: angular acceleration (rad/s^2)",
+    "dth: angular displacement (rad)",
+    "s, v, at: arc length, speed, tangential",
+    "  acceleration at radius r",
+    "ac: final centripetal acceleration",
+    "rev: revolutions turned",
+    "mode/quit button: reset all cells",
+    "del/ins button: clear cell",
+    "math button: sig fig display on/off",
+    "clear button: cancel / quit program",
+};
+
+void drawLegend() {
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+
+    gfx_PrintStringXY("Legend", 137, 5);
+
+    int lineCount = sizeof(legendLines) / sizeof(legendLines[0]);
+    for (int i = 0; i < lineCount; i++) {
+        gfx_PrintStringXY(legendLines[i], 10, 20 + i * 11);
+    }
+
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("Any key to return", 101, 225);
+
+    gfx_BlitBuffer();
+
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setCell(curRow, curCol, true, parseInput(), countSigFigs(inputBuf));
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, curCol, false, 0);
+    autoSolve();
+}
+
+void moveCursor(int dRow, int dCol) {
+    if (curRow == RADIUS_ROW) {
+        if (dCol < 0) curCol = COL_TAN;
+        if (dCol > 0) curCol = COL_ANG;
+        curRow = 0;
+        return;
+    }
+    if (dCol > 0 && curCol == COL_TAN && curRow == 0) {
+        curRow = RADIUS_ROW;
+        return;
+    }
+    curRow = (curRow + dRow + ROWS) % ROWS;
+    curCol = (curCol + dCol + COLS) % COLS;
+}
+
+// The table and its angular, tangential and linking equations.
+const ModChunk stateChunks[] = {
+    {&st, sizeof(st)},
+    {angEqUsed, sizeof(angEqUsed)},
+    {tanEqUsed, sizeof(tanEqUsed)},
+    {linkEqUsed, sizeof(linkEqUsed)}
+};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(ROT_STATE_VAR);
+    if (!resume || !loadModState(ROT_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevLeft = false, prevRight = false;
+    bool prevEnter = false, prevClear = false, prevDel = false;
+    bool prevMode = false, prevTrace = false, prevMath = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool left = kb_Data[7] & kb_Left;
+        bool right = kb_Data[7] & kb_Right;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool trace = kb_Data[1] & kb_Trace;
+        bool math = kb_Data[2] & kb_Math;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int dRow = 0, dCol = 0;
+        if (up && !prevUp) dRow = -1;
+        if (down && !prevDown) dRow = 1;
+        if (left && !prevLeft) dCol = -1;
+        if (right && !prevRight) dCol = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (trace && !prevTrace) drawLegend();
+            if (math && !prevMath) sigFigMode = !sigFigMode;
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel);
+
+            if ((enter && !prevEnter) || dRow || dCol) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        if (dRow || dCol) moveCursor(dRow, dCol);
+
+        prevUp = up; prevDown = down; prevLeft = left; prevRight = right;
+        prevEnter = enter; prevClear = clear; prevDel = del;
+        prevMode = mode; prevTrace = trace; prevMath = math;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(ROT_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
@@ -0,0 +1,345 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "degtrig.h"
+#include "arrow.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define VEC_MAX 10
+#define FIELDS 4
+#define F_MAG 0
+#define F_ANG 1
+#define F_X 2
+#define F_Y 3
+#define POLAR_BITS (BIT(F_MAG) | BIT(F_ANG))
+#define XY_BITS (BIT(F_X) | BIT(F_Y))
+
+// Row R is the resultant and row E the equilibrant, -R.
+#define ROW_R VEC_MAX
+#define ROW_E (VEC_MAX + 1)
+#define ROWS (VEC_MAX + 2)
+
+// Rounding in the running sum builds up with each edit, so it is rebuilt
+// from the rows now and then.
+#define RESUM_EVERY 32
+
+#define DIAG_LEFT 10
+#define DIAG_TOP 20
+#define DIAG_W 300
+#define DIAG_H 196
+
+// The rows are kept as parallel arrays so a whole column goes through the
+// batch kernels at once.
+struct Workbench {
+    float vals[FIELDS][VEC_MAX];
+    uint8_t known[VEC_MAX], userSet[VEC_MAX];
+    float sumX, sumY;
+    int edits;
+    bool pathDirty;
+    float tipX[VEC_MAX + 1], tipY[VEC_MAX + 1];
+};
+
+Workbench wb;
+
+int curRow = 0;
+int curCol = 0;
+
+const char* fieldTitles[FIELDS] = {"|v|", "ang", "x", "y"};
+const uint8_t rowColors[VEC_MAX] = {24, 7, 100, 160, 148, 30, 227, 19, 200, 96};
+
+bool rowActive(int i) {
+    return (wb.known[i] & XY_BITS) == XY_BITS;
+}
+
+// Rebuilds the sum from every row in one pass.
+void resum() {
+    wb.sumX = wb.sumY = 0;
+    for (int i = 0; i < VEC_MAX; i++) {
+        if (!rowActive(i)) continue;
+        wb.sumX += wb.vals[F_X][i];
+        wb.sumY += wb.vals[F_Y][i];
+    }
+    wb.edits = 0;
+}
+
+void initData() {
+    memset(&wb, 0, sizeof(wb));
+    wb.pathDirty = true;
+}
+
+// Fills in the other form of row i from whichever pair the user entered.
+void resolveRow(int i) {
+    float* v[FIELDS] = {wb.vals[F_MAG], wb.vals[F_ANG], wb.vals[F_X], wb.vals[F_Y]};
+    wb.known[i] = wb.userSet[i];
+    if ((wb.userSet[i] & POLAR_BITS) == POLAR_BITS) {
+        polarToXY(&v[F_MAG][i], &v[F_ANG][i], &v[F_X][i], &v[F_Y][i], 1);
+        wb.known[i] |= XY_BITS;
+    } else if ((wb.userSet[i] & XY_BITS) == XY_BITS) {
+        xyToPolar(&v[F_X][i], &v[F_Y][i], &v[F_MAG][i], &v[F_ANG][i], 1);
+        wb.known[i] |= POLAR_BITS;
+    }
+}
+
+// Editing one row takes its old components out of the sum and puts the new
+// ones in, so the resultant costs the same with one row or ten.
+void setCell(int i, int f, bool set, float val) {
+    if (rowActive(i)) {
+        wb.sumX -= wb.vals[F_X][i];
+        wb.sumY -= wb.vals[F_Y][i];
+    }
+    // A row is either polar or component; typing into one pair drops the other.
+    uint8_t pair = (f <= F_ANG) ? POLAR_BITS : XY_BITS;
+    wb.userSet[i] &= pair;
+    wb.vals[f][i] = set ? val : 0;
+    if (set) wb.userSet[i] |= BIT(f);
+    else wb.userSet[i] &= ~BIT(f);
+    resolveRow(i);
+    if (rowActive(i)) {
+        wb.sumX += wb.vals[F_X][i];
+        wb.sumY += wb.vals[F_Y][i];
+    }
+    if (++wb.edits >= RESUM_EVERY) resum();
+    wb.pathDirty = true;
+}
+
+void resultant(float* mag, float* ang) {
+    xyToPolar(&wb.sumX, &wb.sumY, mag, ang, 1);
+}
+
+// Tip of each arrow in the tip-to-tail chain, rebuilt only after an edit.
+void updatePath() {
+    if (!wb.pathDirty) return;
+    float x = 0, y = 0;
+    wb.tipX[0] = wb.tipY[0] = 0;
+    for (int i = 0; i < VEC_MAX; i++) {
+        if (rowActive(i)) {
+            x += wb.vals[F_X][i];
+            y += wb.vals[F_Y][i];
+        }
+        wb.tipX[i + 1] = x;
+        wb.tipY[i + 1] = y;
+    }
+    wb.pathDirty = false;
+}
+
+// Draws the chain tail to tip from the cached endpoints, with the resultant
+// from the origin to the last tip.
+void runDiagram() {
+    updatePath();
+    int count = 0;
+    float minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for (int i = 1; i <= VEC_MAX; i++) {
+        if (!rowActive(i - 1)) continue;
+        count++;
+        minX = fminf(minX, wb.tipX[i]);
+        maxX = fmaxf(maxX, wb.tipX[i]);
+        minY = fminf(minY, wb.tipY[i]);
+        maxY = fmaxf(maxY, wb.tipY[i]);
+    }
+    if (count == 0) {
+        drawMessage("Enter at least one vector");
+        return;
+    }
+    float w = maxX - minX, h = maxY - minY;
+    float span = (w * DIAG_H > h * DIAG_W) ? w / DIAG_W : h / DIAG_H;
+    if (span <= 0) span = 1;
+    float scale = 0.9f / span;
+    int ox = DIAG_LEFT + DIAG_W / 2 - (int)(0.5f * (minX + maxX) * scale);
+    int oy = DIAG_TOP + DIAG_H / 2 + (int)(0.5f * (minY + maxY) * scale);
+
+    gfx_FillScreen(255);
+    gfx_SetColor(200);
+    gfx_HorizLine(DIAG_LEFT, oy, DIAG_W);
+    gfx_VertLine(ox, DIAG_TOP, DIAG_H);
+    char label[15];
+    for (int i = 0; i < VEC_MAX; i++) {
+        if (!rowActive(i)) continue;
+        int x0 = ox + (int)(wb.tipX[i] * scale), y0 = oy - (int)(wb.tipY[i] * scale);
+        int x1 = ox + (int)(wb.tipX[i + 1] * scale), y1 = oy - (int)(wb.tipY[i + 1] * scale);
+        gfx_SetColor(rowColors[i]);
+        drawArrow(x0, y0, x1, y1);
+        gfx_SetTextFGColor(rowColors[i]);
+        floatToStr((float)(i + 1), label);
+        gfx_PrintStringXY(label, (x0 + x1) / 2 + 4, (y0 + y1) / 2 - 4);
+    }
+    gfx_SetColor(224);
+    drawArrow(ox, oy, ox + (int)(wb.sumX * scale), oy - (int)(wb.sumY * scale));
+
+    char buf[15];
+    float mag, ang;
+    resultant(&mag, &ang);
+    gfx_SetTextFGColor(224);
+    gfx_PrintStringXY("R:", 5, 4);
+    floatToStr(mag, buf);
+    gfx_PrintStringXY(buf, 24, 4);
+    gfx_PrintStringXY("at", 112, 4);
+    floatToStr(ang, buf);
+    gfx_PrintStringXY(buf, 132, 4);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("Any key to return", 101, 228);
+    gfx_BlitBuffer();
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+void drawTable() {
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("VECTOR SUM - Evan Kolberg", 60, 3);
+
+    int startX = 5;
+    int startY = 14;
+    int rowH = 14;
+    int labelW = 24;
+    int colW = 72;
+
+    for (int f = 0; f < FIELDS; f++) {
+        gfx_PrintStringXY(fieldTitles[f], startX + labelW + f * colW + 4, startY + 2);
+    }
+    gfx_SetColor(0);
+    gfx_HorizLine(startX, startY + rowH - 2, labelW + colW * FIELDS);
+
+    float rMag, rAng;
+    resultant(&rMag, &rAng);
+    float eAng = (rAng >= 180) ? rAng - 180 : rAng + 180;
+    float rVals[2][FIELDS] = {{rMag, rAng, wb.sumX, wb.sumY}, {rMag, eAng, -wb.sumX, -wb.sumY}};
+
+    char buf[15];
+    for (int row = 0; row < ROWS; row++) {
+        int y = startY + rowH + row * rowH + (row >= ROW_R ? 4 : 0);
+        gfx_SetTextFGColor(0);
+        if (row == ROW_R) gfx_PrintStringXY("R", startX + 2, y + 2);
+        else if (row == ROW_E) gfx_PrintStringXY("E", startX + 2, y + 2);
+        else {
+            floatToStr((float)(row + 1), buf);
+            gfx_PrintStringXY(buf, startX + 2, y + 2);
+        }
+        for (int f = 0; f < FIELDS; f++) {
+            int x = startX + labelW + f * colW;
+            if (row >= ROW_R) {
+                floatToStr(rVals[row - ROW_R][f], buf);
+                gfx_SetTextFGColor(row == ROW_R ? 224 : 24);
+                gfx_PrintStringXY(buf, x + 3, y + 2);
+                continue;
+            }
+            bool selected = (row == curRow && f == curCol && !inputMode);
+            bool editing = (row == curRow && f == curCol && inputMode);
+            if (selected) {
+                gfx_SetColor(183);
+                gfx_FillRectangle(x, y, colW - 2, rowH - 2);
+            } else if (editing) {
+                gfx_SetColor(239);
+                gfx_FillRectangle(x, y, colW - 2, rowH - 2);
+            }
+            gfx_SetColor(0);
+            gfx_Rectangle(x, y, colW - 2, rowH - 2);
+            if (editing) {
+                gfx_SetTextFGColor(0);
+                inputText(buf);
+                gfx_PrintStringXY(buf, x + 3, y + 2);
+            } else if (wb.known[row] & BIT(f)) {
+                floatToStr(wb.vals[f][row], buf);
+                gfx_SetTextFGColor((wb.userSet[row] & BIT(f)) ? 0 : 24);
+                gfx_PrintStringXY(buf, x + 3, y + 2);
+            }
+        }
+    }
+
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("graph: tip to tail   angles in deg", 5, 220);
+    gfx_PrintStringXY("del: clear  mode: reset  clear: quit", 5, 230);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) setCell(curRow, curCol, true, parseInput());
+    inputMode = false;
+}
+
+void clearCell() {
+    setCell(curRow, curCol, false, 0);
+}
+
+// The whole workbench, sum and tip path included, so the diagram needs no
+// recompute.
+const ModChunk stateChunks[] = {{&wb, sizeof(wb)}};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(VEC_STATE_VAR);
+    if (!resume || !loadModState(VEC_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) initData();
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevLeft = false, prevRight = false;
+    bool prevEnter = false, prevClear = false, prevDel = false, prevMode = false;
+    bool prevGraph = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool left = kb_Data[7] & kb_Left;
+        bool right = kb_Data[7] & kb_Right;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0, side = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+        if (left && !prevLeft) side = -1;
+        if (right && !prevRight) side = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) initData();
+            if (graph && !prevGraph) runDiagram();
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move || side) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        curRow = (curRow + move + VEC_MAX) % VEC_MAX;
+        curCol = (curCol + side + FIELDS) % FIELDS;
+
+        prevUp = up; prevDown = down; prevLeft = left; prevRight = right;
+        prevEnter = enter; prevClear = clear; prevDel = del; prevMode = mode;
+        prevGraph = graph; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(VEC_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}
@@ -0,0 +1,379 @@
+#include <tice.h>
+#include <graphx.h>
+#include <keypadc.h>
+#include <ti/real.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "kinematics.h"
+#include "propagate.h"
+#include "modstate.h"
+#include "tableinput.h"
+
+#define GRAVITY 9.81f
+
+// Paired rows hold an initial and a final value side by side; the rest are
+// single values for the whole process.
+#define PAIR_ROWS 6
+#define ROWS 12
+#define COLS 2
+
+#define E_VI 0
+#define E_VF 1
+#define E_HI 2
+#define E_HF 3
+#define E_XI 4
+#define E_XF 5
+#define E_KI 6
+#define E_KF 7
+#define E_UGI 8
+#define E_UGF 9
+#define E_USI 10
+#define E_USF 11
+#define E_M 12
+#define E_G 13
+#define E_SK 14
+#define E_W 15
+#define E_P 16
+#define E_T 17
+#define E_COUNT 18
+
+#define LEDGER_TERMS 9
+
+struct EnergyState {
+    float vals[E_COUNT];
+    uint32_t known, userSet;
+};
+
+EnergyState es;
+
+int curRow = 0;
+int curCol = 0;
+
+const char* rowLabels[ROWS] = {"v", "h", "x", "K", "Ug", "Us", "m", "g", "k", "Wnc", "P", "t"};
+const char* rowUnits[ROWS] = {"m/s", "m", "m", "J", "J", "J", "kg", "m/s^2", "N/m", "J", "W", "s"};
+
+// Ei + Wnc = Ef with each energy built from its own row; x is the spring's
+// stretch from rest and Wnc the work of everything that is not g or the spring.
+const Relation energyRels[] = {
+    {REL_PRODUCT, 3, {E_KI, E_M, E_VI}, {0.5f}, {1, 1, 2}, "Ki = 1/2*m*vi^2"},
+    {REL_PRODUCT, 3, {E_KF, E_M, E_VF}, {0.5f}, {1, 1, 2}, "Kf = 1/2*m*vf^2"},
+    {REL_PRODUCT, 4, {E_UGI, E_M, E_G, E_HI}, {1}, {1, 1, 1, 1}, "Ugi = m*g*hi"},
+    {REL_PRODUCT, 4, {E_UGF, E_M, E_G, E_HF}, {1}, {1, 1, 1, 1}, "Ugf = m*g*hf"},
+    {REL_PRODUCT, 3, {E_USI, E_SK, E_XI}, {0.5f}, {1, 1, 2}, "Usi = 1/2*k*xi^2"},
+    {REL_PRODUCT, 3, {E_USF, E_SK, E_XF}, {0.5f}, {1, 1, 2}, "Usf = 1/2*k*xf^2"},
+    {REL_PRODUCT, 3, {E_P, E_W, E_T}, {1}, {1, 1, -1}, "P = Wnc/t"},
+    {REL_SUM, 7, {E_KI, E_UGI, E_USI, E_W, E_KF, E_UGF, E_USF}, {1, 1, 1, 1, -1, -1, -1}, {0}, "Ki+Ugi+Usi+Wnc = Kf+Ugf+Usf"}
+};
+
+char eqUsed[64] = "";
+
+void initData() {
+    memset(&es, 0, sizeof(es));
+    es.vals[E_G] = GRAVITY;
+    es.known = es.userSet = VBIT(E_G);
+}
+
+int cellVar(int row, int col) {
+    return (row < PAIR_ROWS) ? 2 * row + col : PAIR_ROWS + row;
+}
+
+bool isKnown(int i) {
+    return es.known & VBIT(i);
+}
+
+void autoSolve() {
+    eqUsed[0] = '\0';
+    es.known &= es.userSet;
+    propagate(energyRels, sizeof(energyRels) / sizeof(energyRels[0]), es.vals, &es.known, eqUsed);
+}
+
+void setVar(int i, bool set, float val) {
+    es.vals[i] = set ? val : 0;
+    if (set) {
+        es.known |= VBIT(i);
+        es.userSet |= VBIT(i);
+    } else {
+        es.known &= ~VBIT(i);
+        es.userSet &= ~VBIT(i);
+    }
+}
+
+// Clears the motion rows before an import but keeps m, g and k, which the
+// source program may not know about.
+void clearMotion() {
+    for (int i = 0; i < E_COUNT; i++) {
+        if (i != E_M && i != E_G && i != E_SK) setVar(i, false, 0);
+    }
+}
+
+// Takes launch and landing speed and height straight from PROJMOT's last
+// solved state. Only gravity acts in flight, so Us and Wnc are zero.
+void importProjectile() {
+    static ProjState<float> p;
+    if (!loadModState(PROJ_STATE_VAR, &p, sizeof(p))) {
+        drawMessage("Run PROJMOT first");
+        return;
+    }
+    clearMotion();
+    if (p.extraKnown & BIT(EX_SPEED)) setVar(E_VI, true, p.extraVals[EX_SPEED]);
+    if (p.extraKnown & BIT(EX_VF)) setVar(E_VF, true, p.extraVals[EX_VF]);
+    if (p.yKnown & BIT(0)) setVar(E_HI, true, p.yVals[0]);
+    if (p.yKnown & BIT(1)) setVar(E_HF, true, p.yVals[1]);
+    setVar(E_XI, true, 0);
+    setVar(E_XF, true, 0);
+    setVar(E_W, true, 0);
+    autoSolve();
+}
+
+// Takes OSCMOT's spring from a turning point (x = A, at rest) to the middle
+// of the swing (x = 0, moving at vmax), on the level and without losses.
+void importSpring() {
+    static OscState sys[OSC_SYSTEMS];
+    if (!loadModState(OSC_STATE_VAR, sys, sizeof(sys))) {
+        drawMessage("Run OSCMOT first");
+        return;
+    }
+    const OscState& s = sys[0];
+    clearMotion();
+    if (s.known & BIT(SP_M)) setVar(E_M, true, s.vals[SP_M]);
+    if (s.known & BIT(SP_K)) setVar(E_SK, true, s.vals[SP_K]);
+    if (s.known & BIT(SP_A)) setVar(E_XI, true, s.vals[SP_A]);
+    if (s.known & BIT(SP_VMAX)) setVar(E_VF, true, s.vals[SP_VMAX]);
+    setVar(E_VI, true, 0);
+    setVar(E_XF, true, 0);
+    setVar(E_HI, true, 0);
+    setVar(E_HF, true, 0);
+    setVar(E_W, true, 0);
+    autoSolve();
+}
+
+// One signed bar per term, before on top and after below, with the two
+// totals last so a mismatch in the balance shows at a glance.
+void runLedger() {
+    const int terms[7] = {E_KI, E_UGI, E_USI, E_W, E_KF, E_UGF, E_USF};
+    for (int i = 0; i < 7; i++) {
+        if (!isKnown(terms[i])) {
+            drawMessage("Need every energy term");
+            return;
+        }
+    }
+    const float* v = es.vals;
+    float bars[LEDGER_TERMS] = {v[E_KI], v[E_UGI], v[E_USI], v[E_W], v[E_KI] + v[E_UGI] + v[E_USI] + v[E_W],
+                                v[E_KF], v[E_UGF], v[E_USF], v[E_KF] + v[E_UGF] + v[E_USF]};
+    const char* names[LEDGER_TERMS] = {"Ki", "Ugi", "Usi", "Wnc", "Ei+W", "Kf", "Ugf", "Usf", "Ef"};
+    const uint8_t colors[LEDGER_TERMS] = {224, 7, 100, 160, 0, 224, 7, 100, 0};
+
+    float maxAbs = 0;
+    for (int i = 0; i < LEDGER_TERMS; i++) {
+        if (fabsf(bars[i]) > maxAbs) maxAbs = fabsf(bars[i]);
+    }
+    int zeroX = 160, halfW = 100, barH = 14, top = 24;
+    float scale = (maxAbs > 0) ? halfW / maxAbs : 0;
+
+    char buf[15];
+    gfx_FillScreen(255);
+    gfx_SetTextFGColor(0);
+    gfx_PrintStringXY("ENERGY LEDGER (J)", 92, 4);
+    for (int i = 0; i < LEDGER_TERMS; i++) {
+        int y = top + i * (barH + 8) + (i >= 5 ? 8 : 0);
+        int w = (int)(bars[i] * scale);
+        gfx_SetColor(colors[i]);
+        if (w >= 0) gfx_FillRectangle(zeroX, y, w + 1, barH);
+        else gfx_FillRectangle(zeroX + w, y, -w + 1, barH);
+        gfx_SetTextFGColor(0);
+        gfx_PrintStringXY(names[i], 4, y + 3);
+        floatToStr(bars[i], buf, 4);
+        gfx_PrintStringXY(buf, (w >= 0) ? 8 + 32 : zeroX + 6, y + 3);
+    }
+    gfx_SetColor(0);
+    gfx_VertLine(zeroX, top - 4, 9 * (barH + 8) + 8);
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("Any key to return", 101, 228);
+    gfx_BlitBuffer();
+    while (!kb_AnyKey()) kb_Scan();
+    waitKeyRelease();
+}
+
+void drawCell(int row, int col, int x, int y, int boxW, int rowH) {
+    int i = cellVar(row, col);
+    bool selected = (row == curRow && col == curCol && !inputMode);
+    bool editing = (row == curRow && col == curCol && inputMode);
+    if (selected) {
+        gfx_SetColor(183);
+        gfx_FillRectangle(x, y, boxW, rowH - 2);
+    } else if (editing) {
+        gfx_SetColor(239);
+        gfx_FillRectangle(x, y, boxW, rowH - 2);
+    }
+    gfx_SetColor(0);
+    gfx_Rectangle(x, y, boxW, rowH - 2);
+
+    char buf[15];
+    if (editing) {
+        inputText(buf);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else if (isKnown(i)) {
+        floatToStr(es.vals[i], buf);
+        gfx_SetTextFGColor((es.userSet & VBIT(i)) ? 0 : 24);
+        gfx_PrintStringXY(buf, x + 3, y + 3);
+    } else {
+        gfx_PrintStringXY("?", x + boxW / 2 - 4, y + 3);
+    }
+    gfx_SetTextFGColor(0);
+}
+
+void drawTable() {
+    gfx_FillScreen(255);
+
+    gfx_SetTextFGColor(0);
+    gfx_SetTextScale(1, 1);
+    gfx_PrintStringXY("WORK & ENERGY - Evan Kolberg", 48, 3);
+
+    int startX = 5;
+    int startY = 16;
+    int rowH = 15;
+    int labelW = 28;
+    int colW = 66;
+
+    gfx_PrintStringXY("initial", startX + labelW + 6, startY + 2);
+    gfx_PrintStringXY("final", startX + labelW + colW + 14, startY + 2);
+    gfx_SetColor(0);
+    gfx_HorizLine(startX, startY + rowH - 2, labelW + colW * 2);
+
+    for (int row = 0; row < ROWS; row++) {
+        int y = startY + rowH + row * rowH;
+        int cols = (row < PAIR_ROWS) ? COLS : 1;
+        gfx_PrintStringXY(rowLabels[row], startX + 2, y + 3);
+        for (int col = 0; col < cols; col++) {
+            drawCell(row, col, startX + labelW + col * colW, y, colW - 2, rowH);
+        }
+        gfx_PrintStringXY(rowUnits[row], startX + labelW + cols * colW + 2, y + 3);
+    }
+
+    char buf[15];
+    int rightX = 200;
+    gfx_SetTextFGColor(24);
+    gfx_PrintStringXY("LEDGER", rightX, startY + 2);
+    const float* v = es.vals;
+    if (isKnown(E_KI) && isKnown(E_UGI) && isKnown(E_USI)) {
+        gfx_PrintStringXY("Ei:", rightX, startY + rowH + 3);
+        floatToStr(v[E_KI] + v[E_UGI] + v[E_USI], buf);
+        gfx_PrintStringXY(buf, rightX + 28, startY + rowH + 3);
+    }
+    if (isKnown(E_KF) && isKnown(E_UGF) && isKnown(E_USF)) {
+        gfx_PrintStringXY("Ef:", rightX, startY + 2 * rowH + 3);
+        floatToStr(v[E_KF] + v[E_UGF] + v[E_USF], buf);
+        gfx_PrintStringXY(buf, rightX + 28, startY + 2 * rowH + 3);
+    }
+    gfx_PrintStringXY("window: PROJMOT", rightX, startY + 4 * rowH);
+    gfx_PrintStringXY("zoom: OSCMOT", rightX, startY + 5 * rowH);
+    gfx_PrintStringXY("graph: ledger", rightX, startY + 6 * rowH);
+    gfx_PrintStringXY(",: EE (x10^)", rightX, startY + 7 * rowH);
+    gfx_PrintStringXY("del: clear cell", rightX, startY + 8 * rowH);
+    gfx_PrintStringXY("mode: reset", rightX, startY + 9 * rowH);
+    gfx_PrintStringXY("clear: quit", rightX, startY + 10 * rowH);
+
+    int eqY = startY + (ROWS + 1) * rowH + 4;
+    printEqList(eqUsed, eqY);
+}
+
+void finishInput() {
+    if (inputLen > 0 || isNegative) {
+        setVar(cellVar(curRow, curCol), true, parseInput());
+        autoSolve();
+    }
+    inputMode = false;
+}
+
+void clearCell() {
+    setVar(cellVar(curRow, curCol), false, 0);
+    autoSolve();
+}
+
+// The energy table, imported rows included, and its equations.
+const ModChunk stateChunks[] = {{&es, sizeof(es)}, {eqUsed, sizeof(eqUsed)}};
+
+int main(void) {
+    gfx_Begin();
+    gfx_SetDrawBuffer();
+
+    bool resume = resumeRequested(WORK_STATE_VAR);
+    if (!resume || !loadModState(WORK_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]))) {
+        initData();
+        autoSolve();
+    }
+
+    bool running = true;
+    bool prevUp = false, prevDown = false, prevLeft = false, prevRight = false;
+    bool prevEnter = false, prevClear = false, prevDel = false, prevMode = false;
+    bool prevGraph = false, prevWindow = false, prevZoom = false, prevEe = false;
+    bool prevKeys[10] = {false};
+    bool prevNeg = false, prevDot = false;
+
+    while (running) {
+        drawTable();
+        gfx_BlitBuffer();
+
+        kb_Scan();
+
+        bool up = kb_Data[7] & kb_Up;
+        bool down = kb_Data[7] & kb_Down;
+        bool left = kb_Data[7] & kb_Left;
+        bool right = kb_Data[7] & kb_Right;
+        bool enter = kb_Data[6] & kb_Enter;
+        bool clear = kb_Data[6] & kb_Clear;
+        bool del = kb_Data[1] & kb_Del;
+        bool mode = kb_Data[1] & kb_Mode;
+        bool graph = kb_Data[1] & kb_Graph;
+        bool window = kb_Data[1] & kb_Window;
+        bool zoom = kb_Data[1] & kb_Zoom;
+        bool ee = kb_Data[3] & kb_Comma;
+
+        bool keys[10], pressed[10];
+        readDigitKeys(keys);
+        for (int i = 0; i <= 9; i++) pressed[i] = keys[i] && !prevKeys[i];
+        bool neg = kb_Data[5] & kb_Chs;
+        bool dot = kb_Data[4] & kb_DecPnt;
+
+        int move = 0, side = 0;
+        if (up && !prevUp) move = -1;
+        if (down && !prevDown) move = 1;
+        if (left && !prevLeft) side = -1;
+        if (right && !prevRight) side = 1;
+
+        if (!inputMode) {
+            if (enter && !prevEnter) startInput();
+            if (del && !prevDel) clearCell();
+            if (mode && !prevMode) {
+                initData();
+                autoSolve();
+            }
+            if (window && !prevWindow) importProjectile();
+            if (zoom && !prevZoom) importSpring();
+            if (graph && !prevGraph) runLedger();
+            if (clear && !prevClear) running = false;
+
+            startInputFromKeys(pressed, neg && !prevNeg, dot && !prevDot);
+        } else {
+            typeInputKeys(pressed, neg && !prevNeg, dot && !prevDot, del && !prevDel, ee && !prevEe);
+
+            if ((enter && !prevEnter) || move || side) finishInput();
+            if (clear && !prevClear) cancelInput();
+        }
+        curRow = (curRow + move + ROWS) % ROWS;
+        curCol = (curCol + side + COLS) % COLS;
+        if (curRow >= PAIR_ROWS) curCol = 0;
+
+        prevUp = up; prevDown = down; prevLeft = left; prevRight = right;
+        prevEnter = enter; prevClear = clear; prevDel = del; prevMode = mode;
+        prevGraph = graph; prevWindow = window; prevZoom = zoom; prevEe = ee;
+        for (int i = 0; i <= 9; i++) prevKeys[i] = keys[i];
+        prevNeg = neg; prevDot = dot;
+    }
+
+    saveModState(WORK_STATE_VAR, stateChunks, sizeof(stateChunks) / sizeof(stateChunks[0]));
+    gfx_End();
+    return 0;
+}